@@ -0,0 +1,1150 @@
+//
+// Copyright 2018 Ghyslain Leclerc
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef RANGE_FN_ADAPTORS_HXX_
+#define RANGE_FN_ADAPTORS_HXX_
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "range.hxx"
+
+
+namespace estd {
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//! @brief Iterator type of `Base`, a range or a container (or a reference to
+//! one).
+template< typename Base >
+using iterator_of = decltype( std::declval< Base const& >().begin() );
+
+template< typename Iterator >
+using is_random_access = std::is_base_of<
+   std::random_access_iterator_tag,
+   typename std::iterator_traits< Iterator >::iterator_category
+>;
+
+//! Forward, or input when the iterators of the base are only that.
+template< typename Iterator >
+using forward_category = typename std::conditional<
+   std::is_base_of<
+      std::forward_iterator_tag,
+      typename std::iterator_traits< Iterator >::iterator_category
+   >::value,
+   std::forward_iterator_tag,
+   std::input_iterator_tag
+>::type;
+
+template< typename T >
+struct is_range_object : std::false_type {};
+
+template<
+   typename T, Length length, Direction direction,
+   template< typename, Length, Direction > class Iterator
+>
+struct is_range_object< Range< T, length, direction, Iterator > > : std::true_type {};
+
+template< typename Base, typename Result >
+using if_range_object = enable_if_t< is_range_object< remove_cvref_t< Base > >::value, Result >;
+
+template< typename Base >
+using unless_range_object = enable_if_t< !is_range_object< remove_cvref_t< Base > >::value >;
+
+//! @brief Type of a range with the same values, last to first: ranges with a
+//! compile time direction go the other way.
+template< typename Range >
+struct reversed_range;
+
+template<
+   typename T, Length length, Direction direction,
+   template< typename, Length, Direction > class Iterator
+>
+struct reversed_range< Range< T, length, direction, Iterator > > {
+   using type = Range<
+      T, length,
+      ( direction == Ascending ) ? Descending :
+         ( direction == Descending ) ? Ascending : Runtime,
+      Iterator
+   >;
+};
+
+template< typename Base >
+using reversed_range_t = typename reversed_range< remove_cvref_t< Base > >::type;
+
+template< typename Base >
+using value_of = typename remove_cvref_t< Base >::value_type;
+
+
+
+//------------------------------------------------------------------------------
+//! @brief The function of a transform or filter view, as its iterators hold
+//! it: a copy when it is trivially copyable (function pointers, lambdas that
+//! capture nothing or only references), so that the iterators stay valid
+//! after the view is copied, moved or destroyed, and a pointer into the view
+//! otherwise.
+template< typename Fn, bool copied = std::is_trivially_copyable< Fn >::value >
+struct stored_function
+{
+public:
+   insist_inline
+   stored_function() : storage_{} {
+   }
+
+   insist_inline explicit
+   stored_function( Fn const* fn ) : storage_{} {
+      ::new( static_cast< void* >( storage_ ) ) Fn( *fn );
+   }
+
+   template< typename... Args >
+   insist_inline
+   auto operator()( Args&&... args ) const
+               -> decltype( std::declval< Fn const& >()( std::forward< Args >( args )... ) ) {
+      return ( *reinterpret_cast< Fn const* >( storage_ ) )( std::forward< Args >( args )... );
+   }
+
+private:
+   alignas( Fn ) unsigned char storage_[ sizeof( Fn ) ];
+};
+
+template< typename Fn >
+struct stored_function< Fn, false >
+{
+public:
+   insist_inline
+   stored_function() : fn_{ nullptr } {
+   }
+
+   insist_inline explicit
+   stored_function( Fn const* fn ) : fn_{ fn } {
+   }
+
+   template< typename... Args >
+   insist_inline
+   auto operator()( Args&&... args ) const
+               -> decltype( std::declval< Fn const& >()( std::forward< Args >( args )... ) ) {
+      return (*fn_)( std::forward< Args >( args )... );
+   }
+
+private:
+   Fn const* fn_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Iterator yielding `fn( *it )` for each iterator `it` of a base.
+//!
+//! Moves and compares like the iterator it wraps, so it is as random access as
+//! that one.  The function is held as a stored_function.
+template< typename Iterator, typename Fn >
+struct transform_iterator
+{
+public:
+   using reference = decltype( std::declval< Fn const& >()( *std::declval< Iterator const& >() ) );
+   using value_type = remove_cvref_t< reference >;
+   using iterator_category = typename std::iterator_traits< Iterator >::iterator_category;
+   using pointer = void;
+   using difference_type = std::ptrdiff_t;
+
+   insist_inline
+   transform_iterator() : it_{}, fn_{} {
+   }
+
+   insist_inline
+   transform_iterator( Iterator it, Fn const* fn ) : it_( it ), fn_( fn ) {
+   }
+
+   insist_inline
+   auto operator*() const -> reference {
+      return fn_( *it_ );
+   }
+
+   insist_inline
+   auto operator[]( std::ptrdiff_t n ) const -> reference {
+      return fn_( *( it_ + n ) );
+   }
+
+   insist_inline
+   auto operator++() -> transform_iterator& {
+      ++it_;
+      return *this;
+   }
+
+   insist_inline
+   auto operator++( int ) -> transform_iterator {
+      auto copy = *this;
+      ++it_;
+      return copy;
+   }
+
+   insist_inline
+   auto operator--() -> transform_iterator& {
+      --it_;
+      return *this;
+   }
+
+   insist_inline
+   auto operator--( int ) -> transform_iterator {
+      auto copy = *this;
+      --it_;
+      return copy;
+   }
+
+   insist_inline
+   auto operator+=( std::ptrdiff_t n ) -> transform_iterator& {
+      it_ += n;
+      return *this;
+   }
+
+   insist_inline
+   auto operator-=( std::ptrdiff_t n ) -> transform_iterator& {
+      it_ -= n;
+      return *this;
+   }
+
+   insist_inline
+   friend auto operator+( transform_iterator it, std::ptrdiff_t n ) -> transform_iterator {
+      return it += n;
+   }
+
+   insist_inline
+   friend auto operator+( std::ptrdiff_t n, transform_iterator it ) -> transform_iterator {
+      return it += n;
+   }
+
+   insist_inline
+   friend auto operator-( transform_iterator it, std::ptrdiff_t n ) -> transform_iterator {
+      return it -= n;
+   }
+
+   insist_inline
+   auto operator-( transform_iterator const& rhs ) const -> std::ptrdiff_t {
+      return static_cast< std::ptrdiff_t >( it_ - rhs.it_ );
+   }
+
+   insist_inline
+   bool operator==( transform_iterator const& rhs ) const {
+      return it_ == rhs.it_;
+   }
+
+   insist_inline
+   bool operator!=( transform_iterator const& rhs ) const {
+      return it_ != rhs.it_;
+   }
+
+   insist_inline
+   bool operator<( transform_iterator const& rhs ) const {
+      return it_ < rhs.it_;
+   }
+
+   insist_inline
+   bool operator>( transform_iterator const& rhs ) const {
+      return rhs.it_ < it_;
+   }
+
+   insist_inline
+   bool operator<=( transform_iterator const& rhs ) const {
+      return !( rhs.it_ < it_ );
+   }
+
+   insist_inline
+   bool operator>=( transform_iterator const& rhs ) const {
+      return !( it_ < rhs.it_ );
+   }
+
+private:
+   Iterator it_;
+   stored_function< Fn > fn_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief `fn` applied to each element of a base, when the element is read.
+//! Returned by transform.
+//!
+//! Sized and indexable when the base is.  Its iterators refer to the view,
+//! which must outlive them, when `fn` is not trivially copyable (see
+//! stored_function).
+template< typename Base, typename Fn >
+struct transform_view
+{
+public:
+   using iterator = transform_iterator< iterator_of< Base >, Fn >;
+
+   insist_inline
+   transform_view( Base base, Fn fn ) :
+      base_( std::forward< Base >( base ) ), fn_( std::move( fn ) ) {
+   }
+
+   insist_inline
+   auto begin() const -> iterator {
+      return iterator{ base_.begin(), &fn_ };
+   }
+
+   insist_inline
+   auto end() const -> iterator {
+      return iterator{ base_.end(), &fn_ };
+   }
+
+   //! Number of elements, when the base has a size.
+   insist_inline
+   auto size() const -> std::size_t {
+      return static_cast< std::size_t >( base_.size() );
+   }
+
+   insist_inline
+   auto empty() const -> bool {
+      return begin() == end();
+   }
+
+   //! Element at position `idx`, when the base is random access.
+   insist_inline
+   auto operator[]( std::size_t idx ) const -> typename iterator::reference {
+      return begin()[ static_cast< std::ptrdiff_t >( idx ) ];
+   }
+
+private:
+   Base base_;
+   Fn fn_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Iterator on the elements of a base that satisfy a predicate.
+//!
+//! Forward only: it moves to the next element that satisfies the predicate,
+//! which can be anywhere up to the end of the base.
+template< typename Iterator, typename Pred >
+struct filter_iterator
+{
+public:
+   using reference = decltype( *std::declval< Iterator const& >() );
+   using value_type = typename std::iterator_traits< Iterator >::value_type;
+   using iterator_category = forward_category< Iterator >;
+   using pointer = void;
+   using difference_type = std::ptrdiff_t;
+
+   insist_inline
+   filter_iterator() : it_{}, end_{}, pred_{} {
+   }
+
+   //! Iterator on the first element from `it` on that satisfies `pred`.
+   insist_inline
+   filter_iterator( Iterator it, Iterator end, Pred const* pred ) :
+      it_( it ), end_( end ), pred_( pred ) {
+      satisfy();
+   }
+
+   insist_inline
+   auto operator*() const -> reference {
+      return *it_;
+   }
+
+   insist_inline
+   auto operator++() -> filter_iterator& {
+      ++it_;
+      satisfy();
+      return *this;
+   }
+
+   insist_inline
+   auto operator++( int ) -> filter_iterator {
+      auto copy = *this;
+      ++(*this);
+      return copy;
+   }
+
+   insist_inline
+   bool operator==( filter_iterator const& rhs ) const {
+      return it_ == rhs.it_;
+   }
+
+   insist_inline
+   bool operator!=( filter_iterator const& rhs ) const {
+      return it_ != rhs.it_;
+   }
+
+private:
+   insist_inline
+   void satisfy() {
+      while( it_ != end_ && !pred_( *it_ ) ) { ++it_; }
+   }
+
+   Iterator it_;
+   Iterator end_;
+   stored_function< Pred > pred_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief The elements of a base that satisfy `pred`, found while iterating.
+//! Returned by filter.
+//!
+//! begin() looks for the first element each time it is called.  Its
+//! iterators refer to the view, which must outlive them, when `pred` is not
+//! trivially copyable (see stored_function).
+template< typename Base, typename Pred >
+struct filter_view
+{
+public:
+   using iterator = filter_iterator< iterator_of< Base >, Pred >;
+
+   insist_inline
+   filter_view( Base base, Pred pred ) :
+      base_( std::forward< Base >( base ) ), pred_( std::move( pred ) ) {
+   }
+
+   insist_inline
+   auto begin() const -> iterator {
+      return iterator{ base_.begin(), base_.end(), &pred_ };
+   }
+
+   insist_inline
+   auto end() const -> iterator {
+      return iterator{ base_.end(), base_.end(), &pred_ };
+   }
+
+   insist_inline
+   auto empty() const -> bool {
+      return begin() == end();
+   }
+
+private:
+   Base base_;
+   Pred pred_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Iterator on the elements `first + k * step` of a random access base.
+template< typename Iterator >
+struct index_iterator
+{
+public:
+   using reference = decltype( std::declval< Iterator const& >()[0] );
+   using value_type = remove_cvref_t< reference >;
+   using iterator_category = std::random_access_iterator_tag;
+   using pointer = void;
+   using difference_type = std::ptrdiff_t;
+
+   insist_inline
+   index_iterator() : base_{}, first_{ 0 }, step_{ 1 }, index_{ 0 } {
+   }
+
+   insist_inline
+   index_iterator( Iterator base, std::ptrdiff_t first, std::ptrdiff_t step, std::ptrdiff_t idx ) :
+      base_( base ), first_{ first }, step_{ step }, index_{ idx } {
+   }
+
+   insist_inline
+   auto operator*() const -> reference {
+      return base_[ first_ + index_ * step_ ];
+   }
+
+   insist_inline
+   auto operator[]( std::ptrdiff_t n ) const -> reference {
+      return base_[ first_ + ( index_ + n ) * step_ ];
+   }
+
+   insist_inline
+   auto operator++() -> index_iterator& {
+      ++index_;
+      return *this;
+   }
+
+   insist_inline
+   auto operator++( int ) -> index_iterator {
+      auto copy = *this;
+      ++index_;
+      return copy;
+   }
+
+   insist_inline
+   auto operator--() -> index_iterator& {
+      --index_;
+      return *this;
+   }
+
+   insist_inline
+   auto operator--( int ) -> index_iterator {
+      auto copy = *this;
+      --index_;
+      return copy;
+   }
+
+   insist_inline
+   auto operator+=( std::ptrdiff_t n ) -> index_iterator& {
+      index_ += n;
+      return *this;
+   }
+
+   insist_inline
+   auto operator-=( std::ptrdiff_t n ) -> index_iterator& {
+      index_ -= n;
+      return *this;
+   }
+
+   insist_inline
+   friend auto operator+( index_iterator it, std::ptrdiff_t n ) -> index_iterator {
+      return it += n;
+   }
+
+   insist_inline
+   friend auto operator+( std::ptrdiff_t n, index_iterator it ) -> index_iterator {
+      return it += n;
+   }
+
+   insist_inline
+   friend auto operator-( index_iterator it, std::ptrdiff_t n ) -> index_iterator {
+      return it -= n;
+   }
+
+   insist_inline
+   auto operator-( index_iterator const& rhs ) const -> std::ptrdiff_t {
+      return index_ - rhs.index_;
+   }
+
+   insist_inline
+   bool operator==( index_iterator const& rhs ) const {
+      return index_ == rhs.index_;
+   }
+
+   insist_inline
+   bool operator!=( index_iterator const& rhs ) const {
+      return index_ != rhs.index_;
+   }
+
+   insist_inline
+   bool operator<( index_iterator const& rhs ) const {
+      return index_ < rhs.index_;
+   }
+
+   insist_inline
+   bool operator>( index_iterator const& rhs ) const {
+      return rhs.index_ < index_;
+   }
+
+   insist_inline
+   bool operator<=( index_iterator const& rhs ) const {
+      return !( rhs.index_ < index_ );
+   }
+
+   insist_inline
+   bool operator>=( index_iterator const& rhs ) const {
+      return !( index_ < rhs.index_ );
+   }
+
+private:
+   Iterator base_;
+   std::ptrdiff_t first_;
+   std::ptrdiff_t step_;
+   std::ptrdiff_t index_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Elements of a random access base picked by position: every `step`-th
+//! one from `offset` on, at most `count` of them.  Returned by take, drop,
+//! stride and reverse.
+//!
+//! Random access and sized, in O(1), like its base.
+template< typename Base >
+struct index_view
+{
+public:
+   using iterator = index_iterator< iterator_of< Base > >;
+
+   //! The elements picked are visited last to first when `backwards` is set.
+   insist_inline
+   index_view( Base base, std::size_t offset, std::size_t step, std::size_t count,
+               bool backwards = false ) :
+      base_( std::forward< Base >( base ) ),
+      first_{ 0 },
+      step_{ static_cast< std::ptrdiff_t >( step ) },
+      size_{ 0 } {
+      auto const available = static_cast< std::size_t >( base_.end() - base_.begin() );
+      if( offset < available ) {
+         auto const picked = ( available - offset + step - 1 ) / step;
+         first_ = static_cast< std::ptrdiff_t >( offset );
+         size_ = ( picked < count ) ? picked : count;
+      }
+      if( backwards ) {
+         first_ += ( static_cast< std::ptrdiff_t >( size_ ) - 1 ) * step_;
+         step_ = -step_;
+      }
+   }
+
+   insist_inline
+   auto begin() const -> iterator {
+      return iterator{ base_.begin(), first_, step_, 0 };
+   }
+
+   insist_inline
+   auto end() const -> iterator {
+      return iterator{ base_.begin(), first_, step_, static_cast< std::ptrdiff_t >( size_ ) };
+   }
+
+   insist_inline
+   auto size() const -> std::size_t {
+      return size_;
+   }
+
+   insist_inline
+   auto empty() const -> bool {
+      return size_ == 0;
+   }
+
+   insist_inline
+   auto operator[]( std::size_t idx ) const -> typename iterator::reference {
+      return begin()[ static_cast< std::ptrdiff_t >( idx ) ];
+   }
+
+private:
+   Base base_;
+   std::ptrdiff_t first_;
+   std::ptrdiff_t step_;
+   std::size_t size_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Iterator on every `step`-th element of a base, at most `count` of
+//! them, walking the base.
+//!
+//! Once the count is reached, the iterator is moved to the end of the base,
+//! so that only the base iterators need to be compared.
+template< typename Iterator >
+struct skip_iterator
+{
+public:
+   using reference = decltype( *std::declval< Iterator const& >() );
+   using value_type = typename std::iterator_traits< Iterator >::value_type;
+   using iterator_category = forward_category< Iterator >;
+   using pointer = void;
+   using difference_type = std::ptrdiff_t;
+
+   insist_inline
+   skip_iterator() : it_{}, end_{}, step_{ 1 }, count_{ 0 } {
+   }
+
+   //! Iterator on the element `offset` elements from `it`.
+   insist_inline
+   skip_iterator( Iterator it, Iterator end, std::size_t offset, std::size_t step,
+                  std::size_t count ) :
+      it_( it ), end_( end ), step_{ step }, count_{ count } {
+      for( ; offset != 0 && it_ != end_; --offset ) { ++it_; }
+      if( count_ == 0 ) { it_ = end_; }
+   }
+
+   insist_inline
+   auto operator*() const -> reference {
+      return *it_;
+   }
+
+   insist_inline
+   auto operator++() -> skip_iterator& {
+      if( --count_ == 0 ) {
+         it_ = end_;
+      } else {
+         for( auto left = step_; left != 0 && it_ != end_; --left ) { ++it_; }
+      }
+      return *this;
+   }
+
+   insist_inline
+   auto operator++( int ) -> skip_iterator {
+      auto copy = *this;
+      ++(*this);
+      return copy;
+   }
+
+   insist_inline
+   bool operator==( skip_iterator const& rhs ) const {
+      return it_ == rhs.it_;
+   }
+
+   insist_inline
+   bool operator!=( skip_iterator const& rhs ) const {
+      return it_ != rhs.it_;
+   }
+
+private:
+   Iterator it_;
+   Iterator end_;
+   std::size_t step_;
+   std::size_t count_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief index_view for bases that are not random access (e.g. filter_view):
+//! the elements are reached by walking the base, and there is no size.
+template< typename Base >
+struct skip_view
+{
+public:
+   using iterator = skip_iterator< iterator_of< Base > >;
+
+   insist_inline
+   skip_view( Base base, std::size_t offset, std::size_t step, std::size_t count ) :
+      base_( std::forward< Base >( base ) ), offset_{ offset }, step_{ step }, count_{ count } {
+   }
+
+   insist_inline
+   auto begin() const -> iterator {
+      return iterator{ base_.begin(), base_.end(), offset_, step_, count_ };
+   }
+
+   insist_inline
+   auto end() const -> iterator {
+      return iterator{ base_.end(), base_.end(), 0, step_, 0 };
+   }
+
+   insist_inline
+   auto empty() const -> bool {
+      return begin() == end();
+   }
+
+private:
+   Base base_;
+   std::size_t offset_;
+   std::size_t step_;
+   std::size_t count_;
+};
+
+
+template< typename Base >
+using picked_view = typename std::conditional<
+   is_random_access< iterator_of< Base > >::value, index_view< Base >, skip_view< Base >
+>::type;
+
+
+
+//------------------------------------------------------------------------------
+template< bool... >
+struct bools {};
+
+//! True when all of `values` are (and for none).
+template< bool... values >
+using all_true = std::is_same< bools< values..., true >, bools< true, values... > >;
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Element access for zip: the data pointer of contiguous containers
+//! (and arrays and pointers), so that the loop is over plain pointers, or the
+//! container itself otherwise.
+template< typename Container >
+struct indexed
+{
+   Container* container;
+
+   template< typename Index >
+   insist_inline
+   auto operator[]( Index idx ) const -> decltype( std::declval< Container& >()[idx] ) {
+      return (*container)[idx];
+   }
+};
+
+template< typename T >
+insist_inline
+auto element_access( T* data, int ) -> T* {
+   return data;
+}
+
+template< typename Container >
+insist_inline
+auto element_access( Container& container, int ) -> decltype( container.data() ) {
+   return container.data();
+}
+
+template< typename Container >
+insist_inline
+auto element_access( Container& container, long ) -> indexed< Container > {
+   return indexed< Container >{ &container };
+}
+
+template< typename Container >
+using element_access_t = decltype(
+   element_access( std::declval< remove_reference_t< Container >& >(), 0 )
+);
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Iterator yielding a tuple of an index and of the elements at that
+//! index of each container: `( i, a[i], b[i], ... )`.
+//!
+//! Moves and compares like the iterator of the indices, so that the loop has
+//! the trip count of the range of indices.  Nothing is bounds checked.
+template< typename Iterator, typename... Access >
+struct zip_iterator
+{
+   using index_type = remove_cvref_t< decltype( *std::declval< Iterator const& >() ) >;
+
+public:
+   using value_type = std::tuple<
+      index_type, decltype( std::declval< Access const& >()[ std::declval< index_type >() ] )...
+   >;
+   using reference = value_type;
+   using iterator_category = typename std::iterator_traits< Iterator >::iterator_category;
+   using pointer = void;
+   using difference_type = std::ptrdiff_t;
+
+   insist_inline
+   zip_iterator() : it_{}, access_{} {
+   }
+
+   insist_inline
+   zip_iterator( Iterator it, std::tuple< Access... > const& access ) :
+      it_( it ), access_( access ) {
+   }
+
+   insist_inline
+   auto operator*() const -> reference {
+      return at( *it_, make_index_sequence< sizeof...( Access ) >{} );
+   }
+
+   insist_inline
+   auto operator[]( std::ptrdiff_t n ) const -> reference {
+      return at( it_[n], make_index_sequence< sizeof...( Access ) >{} );
+   }
+
+   insist_inline
+   auto operator++() -> zip_iterator& {
+      ++it_;
+      return *this;
+   }
+
+   insist_inline
+   auto operator++( int ) -> zip_iterator {
+      auto copy = *this;
+      ++it_;
+      return copy;
+   }
+
+   insist_inline
+   auto operator--() -> zip_iterator& {
+      --it_;
+      return *this;
+   }
+
+   insist_inline
+   auto operator--( int ) -> zip_iterator {
+      auto copy = *this;
+      --it_;
+      return copy;
+   }
+
+   insist_inline
+   auto operator+=( std::ptrdiff_t n ) -> zip_iterator& {
+      it_ += n;
+      return *this;
+   }
+
+   insist_inline
+   auto operator-=( std::ptrdiff_t n ) -> zip_iterator& {
+      it_ -= n;
+      return *this;
+   }
+
+   insist_inline
+   friend auto operator+( zip_iterator it, std::ptrdiff_t n ) -> zip_iterator {
+      return it += n;
+   }
+
+   insist_inline
+   friend auto operator+( std::ptrdiff_t n, zip_iterator it ) -> zip_iterator {
+      return it += n;
+   }
+
+   insist_inline
+   friend auto operator-( zip_iterator it, std::ptrdiff_t n ) -> zip_iterator {
+      return it -= n;
+   }
+
+   insist_inline
+   auto operator-( zip_iterator const& rhs ) const -> std::ptrdiff_t {
+      return static_cast< std::ptrdiff_t >( it_ - rhs.it_ );
+   }
+
+   insist_inline
+   bool operator==( zip_iterator const& rhs ) const {
+      return it_ == rhs.it_;
+   }
+
+   insist_inline
+   bool operator!=( zip_iterator const& rhs ) const {
+      return it_ != rhs.it_;
+   }
+
+   insist_inline
+   bool operator<( zip_iterator const& rhs ) const {
+      return it_ < rhs.it_;
+   }
+
+   insist_inline
+   bool operator>( zip_iterator const& rhs ) const {
+      return rhs.it_ < it_;
+   }
+
+   insist_inline
+   bool operator<=( zip_iterator const& rhs ) const {
+      return !( rhs.it_ < it_ );
+   }
+
+   insist_inline
+   bool operator>=( zip_iterator const& rhs ) const {
+      return !( it_ < rhs.it_ );
+   }
+
+private:
+   template< std::size_t... k >
+   insist_inline
+   auto at( index_type idx, index_sequence< k... > ) const -> reference {
+      return reference( idx, std::get< k >( access_ )[idx]... );
+   }
+
+   Iterator it_;
+   std::tuple< Access... > access_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief The indices of a range zipped with the elements of containers at
+//! those indices.  Returned by zip and enumerate.
+template< typename Base, typename... Access >
+struct zip_view
+{
+public:
+   using iterator = zip_iterator< iterator_of< Base >, Access... >;
+
+   insist_inline
+   zip_view( Base base, Access... access ) :
+      base_( std::forward< Base >( base ) ), access_( access... ) {
+   }
+
+   insist_inline
+   auto begin() const -> iterator {
+      return iterator{ base_.begin(), access_ };
+   }
+
+   insist_inline
+   auto end() const -> iterator {
+      return iterator{ base_.end(), access_ };
+   }
+
+   //! Number of indices, when the range of indices has a size.
+   insist_inline
+   auto size() const -> std::size_t {
+      return static_cast< std::size_t >( base_.size() );
+   }
+
+   insist_inline
+   auto empty() const -> bool {
+      return begin() == end();
+   }
+
+   insist_inline
+   auto operator[]( std::size_t idx ) const -> typename iterator::reference {
+      return begin()[ static_cast< std::ptrdiff_t >( idx ) ];
+   }
+
+private:
+   Base base_;
+   std::tuple< Access... > access_;
+};
+
+} // namespace detail
+
+
+
+//------------------------------------------------------------------------------
+//! @brief `fn( x )` for each element `x` of `base`, computed when read.
+//!
+//! Like the other adaptors, `base` is kept by reference when it is an lvalue
+//! and moved in otherwise, so that nothing is copied or allocated.
+template< typename Base, typename Fn >
+insist_inline auto transform( Base&& base, Fn fn ) -> detail::transform_view< Base, Fn > {
+   return detail::transform_view< Base, Fn >{ std::forward< Base >( base ), std::move( fn ) };
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief The elements of `base` for which `pred` is true, in order.
+template< typename Base, typename Pred >
+insist_inline auto filter( Base&& base, Pred pred ) -> detail::filter_view< Base, Pred > {
+   return detail::filter_view< Base, Pred >{ std::forward< Base >( base ), std::move( pred ) };
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief The first `count` elements of `rng` (all of them if it has fewer).
+//!
+//! A range gives a range of the same type (see Range::slice).
+template< typename Base >
+insist_inline constexpr
+auto take( Base&& rng, std::size_t count )
+                     -> detail::if_range_object< Base, remove_cvref_t< Base > > {
+   return rng.slice( 0, ( count < rng.size() ) ? count : rng.size() );
+}
+
+template< typename Base, typename = detail::unless_range_object< Base > >
+insist_inline auto take( Base&& base, std::size_t count ) -> detail::picked_view< Base > {
+   return detail::picked_view< Base >{ std::forward< Base >( base ), 0, 1, count };
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief The elements of `rng` after the first `count` ones.
+template< typename Base >
+insist_inline constexpr
+auto drop( Base&& rng, std::size_t count )
+                     -> detail::if_range_object< Base, remove_cvref_t< Base > > {
+   return rng.slice( ( count < rng.size() ) ? count : rng.size(), rng.size() );
+}
+
+template< typename Base, typename = detail::unless_range_object< Base > >
+insist_inline auto drop( Base&& base, std::size_t count ) -> detail::picked_view< Base > {
+   return detail::picked_view< Base >{
+      std::forward< Base >( base ), count, 1, static_cast< std::size_t >( -1 )
+   };
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Every `step`-th element of `rng`, from the first one.  A null step
+//! is taken as 1.
+//!
+//! A range gives `range( front, stop, step * rng.step() )`: a compile time
+//! direction can not be kept, as the step is no longer one.  Floating point
+//! values are computed from the new step, and can differ from those of `rng`
+//! in the last bit, as those of slice can.
+template< typename Base >
+insist_inline constexpr
+auto stride( Base&& rng, std::size_t step )
+         -> detail::if_range_object< Base, detail::range< detail::value_of< Base > > > {
+   return detail::range< detail::value_of< Base > >{
+      rng.front(),
+      detail::nth_value( detail::value_of< Base >{0}, rng.step(),
+                         static_cast< std::ptrdiff_t >( detail::nonzero_step( step ) ) ),
+      ( rng.size() + detail::nonzero_step( step ) - 1 ) / detail::nonzero_step( step ),
+      detail::counted_t{}
+   };
+}
+
+template< typename Base, typename = detail::unless_range_object< Base > >
+insist_inline auto stride( Base&& base, std::size_t step ) -> detail::picked_view< Base > {
+   return detail::picked_view< Base >{
+      std::forward< Base >( base ), 0, detail::nonzero_step( step ),
+      static_cast< std::size_t >( -1 )
+   };
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief The elements of `rng`, last to first.
+//!
+//! A range gives a range from its back going the other way: up_range and
+//! down_range swap, the others get the opposite step; an empty range gives
+//! an empty range.  Other bases must be random access.
+template< typename Base >
+insist_inline constexpr
+auto reverse( Base&& rng )
+                     -> detail::if_range_object< Base, detail::reversed_range_t< Base > > {
+   return rng.empty() ? detail::reversed_range_t< Base >{} : detail::reversed_range_t< Base >{
+      rng.back(),
+      detail::nth_value( detail::value_of< Base >{0}, rng.step(), -1 ),
+      rng.size(),
+      detail::counted_t{}
+   };
+}
+
+template< typename Base, typename = detail::unless_range_object< Base > >
+insist_inline auto reverse( Base&& base ) -> detail::index_view< Base > {
+   static_assert(
+      detail::is_random_access< detail::iterator_of< Base > >::value,
+      "Only random access ranges can be reversed."
+   );
+   return detail::index_view< Base >{
+      std::forward< Base >( base ), 0, 1, static_cast< std::size_t >( -1 ), true
+   };
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief `( i, containers[i]... )` for each index `i` of `indices`, a range
+//! (or any range of integers), without bounds checking.
+//!
+//! Replaces `for( auto i : estd::range( n ) ) { out[i] = a[i] + b[i]; }`,
+//! with the same loop for the compiler:
+//! `for( auto e : estd::zip( estd::range( n ), out, a, b ) )` with
+//! `std::get< 1 >( e ) = std::get< 2 >( e ) + std::get< 3 >( e )`, or
+//! `auto [i, o, x, y]` in C++17.  The containers (vectors, arrays, pointers,
+//! anything with operator[]) are not copied, so they must outlive the loop;
+//! contiguous ones are accessed through their data pointer.
+template< typename Indices, typename... Containers >
+insist_inline auto zip( Indices&& indices, Containers&&... containers )
+                  -> detail::zip_view< Indices, detail::element_access_t< Containers >... > {
+   static_assert(
+      detail::all_true< ( std::is_lvalue_reference< Containers >::value
+                          || std::is_pointer< remove_reference_t< Containers > >::value )... >::value,
+      "zip refers to its containers: temporaries would be destroyed before the loop."
+   );
+   return detail::zip_view< Indices, detail::element_access_t< Containers >... >{
+      std::forward< Indices >( indices ), detail::element_access( containers, 0 )...
+   };
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief `( i, container[i] )` for each index `i` of `container`.
+template< typename Container >
+insist_inline auto enumerate( Container& container )
+   -> decltype( zip( up_range( container.size() ), container ) ) {
+   return zip( up_range( container.size() ), container );
+}
+
+template< typename T, std::size_t N >
+insist_inline auto enumerate( T (&values)[N] )
+   -> decltype( zip( up_range( N ), values ) ) {
+   return zip( up_range( N ), values );
+}
+
+} // namespace estd
+
+#endif // RANGE_FN_ADAPTORS_HXX_
@@ -0,0 +1,567 @@
+//
+// Copyright 2018 Ghyslain Leclerc
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef RANGE_FN_CURVE_HXX_
+#define RANGE_FN_CURVE_HXX_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#if defined( __BMI2__ )
+#  include <immintrin.h>
+#endif
+
+#include "range.hxx"
+
+
+namespace estd {
+
+//------------------------------------------------------------------------------
+//! @brief Space filling curve along which curve_range visits a 2D space.
+//!
+//!   - morton: Z order; the bits of the row and column are interleaved.
+//!   - hilbert: consecutive points are always neighbours.
+enum class curve : uint_fast8_t {
+   morton,
+   hilbert
+};
+
+
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//! @brief Position in its parent square of the quadrant visited `digit`-th
+//! (0 to 3), and orientation of the curve inside it.
+//!
+//! The Hilbert orientation is one of the symmetries of the square that map
+//! the curve on itself or its reverse: bit 0 swaps row and column, bit 1
+//! turns by half a turn.  They commute, so composing is a xor.
+template< curve order >
+struct curve_step;
+
+template<>
+struct curve_step< curve::morton >
+{
+   static auto row( unsigned, unsigned digit ) -> unsigned {
+      return digit >> 1;
+   }
+
+   static auto column( unsigned, unsigned digit ) -> unsigned {
+      return digit & 1u;
+   }
+
+   static auto child( unsigned state, unsigned ) -> unsigned {
+      return state;
+   }
+};
+
+template<>
+struct curve_step< curve::hilbert >
+{
+   static auto row( unsigned state, unsigned digit ) -> unsigned {
+      auto const row = digit >> 1;
+      auto const column = ( digit ^ row ) & 1u;
+      return ( ( state & 1u ) ? column : row ) ^ ( state >> 1 );
+   }
+
+   static auto column( unsigned state, unsigned digit ) -> unsigned {
+      auto const row = digit >> 1;
+      auto const column = ( digit ^ row ) & 1u;
+      return ( ( state & 1u ) ? row : column ) ^ ( state >> 1 );
+   }
+
+   //! The first quadrant is transposed, the last one anti transposed.
+   static auto child( unsigned state, unsigned digit ) -> unsigned {
+      return state ^ ( ( digit == 0 ) ? 1u : ( digit == 3 ) ? 3u : 0u );
+   }
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Row and column of a point of a 2D space.
+struct curve_point
+{
+   std::uint64_t row;
+   std::uint64_t column;
+};
+
+#if !defined( __BMI2__ )
+//! The even bits of `code`, packed.
+insist_inline
+auto compact_bits( std::uint64_t code ) -> std::uint64_t {
+   code &= 0x5555555555555555u;
+   code = ( code | ( code >> 1 ) ) & 0x3333333333333333u;
+   code = ( code | ( code >> 2 ) ) & 0x0F0F0F0F0F0F0F0Fu;
+   code = ( code | ( code >> 4 ) ) & 0x00FF00FF00FF00FFu;
+   code = ( code | ( code >> 8 ) ) & 0x0000FFFF0000FFFFu;
+   return ( code | ( code >> 16 ) ) & 0x00000000FFFFFFFFu;
+}
+#endif
+
+//! Number of trailing one bits of `code`, which must not be all ones.
+insist_inline
+auto trailing_ones( std::uint64_t code ) -> unsigned {
+#if defined( __GNUC__ ) || defined( __clang__ )
+   return static_cast< unsigned >( __builtin_ctzll( ~code ) );
+#else
+   unsigned count{0};
+   for( ; code & 1u; code >>= 1 ) { ++count; }
+   return count;
+#endif
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Most levels of a curve: it has 4^levels positions, held in 64 bits.
+constexpr unsigned max_levels = 32;
+
+//! @brief Position on a curve over a square of 2^levels points per side, and
+//! the point there.
+template< curve order >
+struct curve_cursor;
+
+//! Z order points are the odd and even bits of the position: O(1), with one
+//! instruction per coordinate when BMI2 is available.
+template<>
+struct curve_cursor< curve::morton >
+{
+   std::uint64_t code;
+   curve_point point;
+
+   insist_inline
+   void seek( std::uint64_t position, curve_point at, unsigned ) {
+      code = position;
+      point = at;
+   }
+
+   insist_inline
+   void next( unsigned ) {
+      ++code;
+#if defined( __BMI2__ )
+      point = curve_point{ _pext_u64( code, 0xAAAAAAAAAAAAAAAAu ),
+                          _pext_u64( code, 0x5555555555555555u ) };
+#else
+      point = curve_point{ compact_bits( code >> 1 ), compact_bits( code ) };
+#endif
+   }
+};
+
+//! Hilbert points depend on the orientation of every enclosing quadrant, so
+//! the orientation at each level is kept.  Moving to the next position only
+//! changes its trailing base 4 digits: 4 / 3 of them on average, so a step is
+//! O(1) amortized.
+template<>
+struct curve_cursor< curve::hilbert >
+{
+   using step = curve_step< curve::hilbert >;
+
+   std::uint64_t code;
+   curve_point point;
+   std::uint8_t states[ max_levels + 1 ];
+
+   insist_inline
+   void seek( std::uint64_t position, curve_point at, unsigned levels ) {
+      code = position;
+      point = at;
+      states[levels] = 0;
+      for( auto level = levels; level-- != 0; ) {
+         auto const digit = static_cast< unsigned >( code >> ( 2 * level ) ) & 3u;
+         states[level] = static_cast< std::uint8_t >( step::child( states[level + 1], digit ) );
+      }
+   }
+
+   insist_inline
+   void next( unsigned levels ) {
+      auto const changed = trailing_ones( code ) / 2 + 1;
+      ++code;
+      for( auto level = ( changed < levels ) ? changed : levels; level-- != 0; ) {
+         auto const digit = static_cast< unsigned >( code >> ( 2 * level ) ) & 3u;
+         auto const state = states[level + 1];
+         auto const bit = std::uint64_t{1} << level;
+         point.row = ( point.row & ~bit ) | ( std::uint64_t{ step::row( state, digit ) } << level );
+         point.column = ( point.column & ~bit )
+                           | ( std::uint64_t{ step::column( state, digit ) } << level );
+         states[level] = static_cast< std::uint8_t >( step::child( state, digit ) );
+      }
+   }
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Number of points of the square of `side` points at (`row`,
+//! `column`) that are in a `rows` by `columns` space.
+insist_inline
+auto points_inside( std::uint64_t row, std::uint64_t column, std::uint64_t side,
+                    std::uint64_t rows, std::uint64_t columns ) -> std::uint64_t {
+   auto const height = ( row >= rows ) ? 0 : ( rows - row < side ) ? rows - row : side;
+   auto const width = ( column >= columns ) ? 0 : ( columns - column < side ) ? columns - column : side;
+   return height * width;
+}
+
+//! Position on the curve of the `idx`-th point that is in a `rows` by
+//! `columns` space, and that point.  Descends the quadrants, skipping those
+//! that hold fewer points than are left to skip: O(levels).
+template< curve order >
+insist_inline
+auto select( std::uint64_t idx, unsigned levels, std::uint64_t rows,
+             std::uint64_t columns ) -> std::pair< std::uint64_t, curve_point > {
+   using step = curve_step< order >;
+   std::uint64_t code{0};
+   curve_point corner{ 0, 0 };
+   unsigned state{0};
+   for( auto level = levels; level-- != 0; ) {
+      auto const side = std::uint64_t{1} << level;
+      for( unsigned digit{0}; digit != 4; ++digit ) {
+         auto const row = corner.row + step::row( state, digit ) * side;
+         auto const column = corner.column + step::column( state, digit ) * side;
+         auto const inside = points_inside( row, column, side, rows, columns );
+         if( idx < inside || digit == 3 ) {
+            code = ( code << 2 ) | digit;
+            corner = curve_point{ row, column };
+            state = step::child( state, digit );
+            break;
+         }
+         idx -= inside;
+      }
+   }
+   return std::make_pair( code, corner );
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Iterator on the points of a curve_range.
+//!
+//! The flat counter is the position among the points of the space, which is
+//! all that is compared.  The position on the curve moves with it; when it
+//! leaves the space (which is not square, or not a power of two), the next
+//! point inside is found by select rather than by walking the curve.
+template< typename T, curve order >
+struct curve_iterator
+{
+public:
+   using value_type = std::array< T, 2 >;
+   using reference = std::array< T, 2 >;
+   using iterator_category = std::random_access_iterator_tag;
+   using pointer = std::array< T, 2 > const*;
+   using difference_type = std::ptrdiff_t;
+
+   insist_inline
+   curve_iterator() : axes_{}, levels_{ 0 }, index_{ 0 }, cursor_{}, values_{} {
+   }
+
+   //! Iterator on the point at position `idx`.
+   insist_inline
+   curve_iterator( std::size_t idx, nd_axes< T, 2 > const& axes, unsigned levels ) :
+      axes_( axes ), levels_{ levels }, index_{ idx }, cursor_{}, values_{} {
+      seek();
+   }
+
+   insist_inline
+   auto operator*() const -> std::array< T, 2 > {
+      return values_;
+   }
+
+   insist_inline
+   auto operator[]( std::ptrdiff_t n ) const -> std::array< T, 2 > {
+      return *( *this + n );
+   }
+
+   insist_inline
+   auto operator++() -> curve_iterator& {
+      ++index_;
+      if( index_ == axes_.size() ) { return *this; }
+      cursor_.next( levels_ );
+      if( cursor_.point.row < axes_.counts[0] && cursor_.point.column < axes_.counts[1] ) {
+         set_values( cursor_.point );
+      } else {
+         seek();
+      }
+      return *this;
+   }
+
+   insist_inline
+   auto operator++( int ) -> curve_iterator {
+      auto copy = *this;
+      ++( *this );
+      return copy;
+   }
+
+   insist_inline
+   auto operator--() -> curve_iterator& {
+      --index_;
+      seek();
+      return *this;
+   }
+
+   insist_inline
+   auto operator--( int ) -> curve_iterator {
+      auto copy = *this;
+      --( *this );
+      return copy;
+   }
+
+   insist_inline
+   auto operator+=( std::ptrdiff_t n ) -> curve_iterator& {
+      index_ += static_cast< std::size_t >( n );
+      seek();
+      return *this;
+   }
+
+   insist_inline
+   auto operator-=( std::ptrdiff_t n ) -> curve_iterator& {
+      return *this += -n;
+   }
+
+   insist_inline
+   friend auto operator+( curve_iterator iter, std::ptrdiff_t n ) -> curve_iterator {
+      return iter += n;
+   }
+
+   insist_inline
+   friend auto operator+( std::ptrdiff_t n, curve_iterator iter ) -> curve_iterator {
+      return iter += n;
+   }
+
+   insist_inline
+   friend auto operator-( curve_iterator iter, std::ptrdiff_t n ) -> curve_iterator {
+      return iter -= n;
+   }
+
+   insist_inline
+   auto operator-( curve_iterator const& rhs ) const -> std::ptrdiff_t {
+      return static_cast< std::ptrdiff_t >( index_ - rhs.index_ );
+   }
+
+   insist_inline
+   auto operator==( curve_iterator const& rhs ) const -> bool {
+      return index_ == rhs.index_;
+   }
+
+   insist_inline
+   auto operator!=( curve_iterator const& rhs ) const -> bool {
+      return index_ != rhs.index_;
+   }
+
+   insist_inline
+   auto operator<( curve_iterator const& rhs ) const -> bool {
+      return index_ < rhs.index_;
+   }
+
+   insist_inline
+   auto operator>( curve_iterator const& rhs ) const -> bool {
+      return rhs < *this;
+   }
+
+   insist_inline
+   auto operator<=( curve_iterator const& rhs ) const -> bool {
+      return !( rhs < *this );
+   }
+
+   insist_inline
+   auto operator>=( curve_iterator const& rhs ) const -> bool {
+      return !( *this < rhs );
+   }
+
+private:
+   insist_inline
+   void set_values( curve_point point ) {
+      values_[0] = nth_value( axes_.firsts[0], axes_.steps[0],
+                              static_cast< std::ptrdiff_t >( point.row ) );
+      values_[1] = nth_value( axes_.firsts[1], axes_.steps[1],
+                              static_cast< std::ptrdiff_t >( point.column ) );
+   }
+
+   insist_inline
+   void seek() {
+      if( index_ >= axes_.size() ) { return; }
+      auto const found = select< order >( index_, levels_, axes_.counts[0], axes_.counts[1] );
+      cursor_.seek( found.first, found.second, levels_ );
+      set_values( found.second );
+   }
+
+   nd_axes< T, 2 > axes_;
+   unsigned levels_;
+   std::size_t index_;
+   curve_cursor< order > cursor_;
+   std::array< T, 2 > values_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief The points of a 2D range in the order of a space filling curve, as
+//! std::array index tuples.  Returned by morton_range and hilbert_range.
+//!
+//! The curve covers the smallest square of a power of two points per side
+//! that contains the range; its points outside of the range are skipped.
+//! Positions on the curve are 64 bit, so a side of more than 2^32 points
+//! throws std::length_error.
+//! Like nd_range, the range can be sliced and split in O(levels), so that
+//! threads get consecutive pieces of the curve.
+template< typename T, curve order >
+struct curve_range
+{
+public:
+   using iterator = curve_iterator< T, order >;
+
+   insist_inline
+   explicit curve_range( nd_axes< T, 2 > const& axes ) :
+      axes_( axes ), levels_{ 0 }, first_{ 0 }, size_{ axes.size() } {
+      auto const side = ( axes.counts[0] > axes.counts[1] ) ? axes.counts[0] : axes.counts[1];
+      if( static_cast< std::uint64_t >( side ) > ( std::uint64_t{1} << max_levels ) ) {
+         throw std::length_error( "curve ranges have at most 2^32 points per side" );
+      }
+      while( ( std::uint64_t{1} << levels_ ) < side ) { ++levels_; }
+   }
+
+   insist_inline
+   auto begin() const -> iterator {
+      return iterator{ first_, axes_, levels_ };
+   }
+
+   insist_inline
+   auto end() const -> iterator {
+      return iterator{ first_ + size_, axes_, levels_ };
+   }
+
+   //! Number of points.
+   insist_inline
+   auto size() const -> std::size_t {
+      return size_;
+   }
+
+   insist_inline
+   auto empty() const -> bool {
+      return size_ == 0;
+   }
+
+   //! First point.  The range must not be empty.
+   insist_inline
+   auto front() const -> std::array< T, 2 > {
+      return (*this)[0];
+   }
+
+   //! Last point.  The range must not be empty.
+   insist_inline
+   auto back() const -> std::array< T, 2 > {
+      return (*this)[ size_ - 1 ];
+   }
+
+   //! Point at position `idx` along the curve, without bounds checking.
+   insist_inline
+   auto operator[]( std::size_t idx ) const -> std::array< T, 2 > {
+      return *iterator{ first_ + idx, axes_, levels_ };
+   }
+
+   //! Points at positions [first, last[, as a range of the same type.
+   insist_inline
+   auto slice( std::size_t first, std::size_t last ) const -> curve_range {
+      auto copy = *this;
+      copy.first_ = first_ + first;
+      copy.size_ = last - first;
+      return copy;
+   }
+
+   //! The two halves of the range; the first one gets the middle point when
+   //! the size is odd.
+   insist_inline
+   auto split() const -> std::pair< curve_range, curve_range > {
+      auto const middle = size_ - size_ / 2;
+      return std::make_pair( slice( 0, middle ), slice( middle, size_ ) );
+   }
+
+private:
+   nd_axes< T, 2 > axes_;
+   unsigned levels_;
+   std::size_t first_;
+   std::size_t size_;
+};
+
+
+
+//------------------------------------------------------------------------------
+template< curve order, typename T >
+insist_inline
+auto make_curve_range( T const (&starts)[2], T const (&stops)[2], T const (&steps)[2] )
+                                                      -> curve_range< T, order > {
+   static_assert(
+      is_allowed_range_type<T>::value,
+      "Only integers, characters and floating points are allowed in ranges."
+   );
+   nd_axes< T, 2 > axes;
+   for( std::size_t axis{0}; axis != 2; ++axis ) {
+      axes.firsts[axis] = starts[axis];
+      axes.steps[axis] = steps[axis];
+      axes.counts[axis] = step_count( starts[axis], stops[axis], steps[axis] );
+   }
+   return curve_range< T, order >{ axes };
+}
+
+} // namespace detail
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Every (row, column) of a `stops[0]` by `stops[1]` space, in Z order.
+template< typename T >
+insist_inline auto morton_range( T const (&stops)[2] )
+                                       -> detail::curve_range< T, curve::morton > {
+   T const starts[2] = { T{0}, T{0} };
+   T const steps[2] = { T{1}, T{1} };
+   return detail::make_curve_range< curve::morton >( starts, stops, steps );
+}
+
+//! The points of `range_nd( starts, stops, steps )`, in Z order.
+template< typename T >
+insist_inline auto morton_range( T const (&starts)[2], T const (&stops)[2],
+                                 T const (&steps)[2] )
+                                       -> detail::curve_range< T, curve::morton > {
+   return detail::make_curve_range< curve::morton >( starts, stops, steps );
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Every (row, column) of a `stops[0]` by `stops[1]` space, along a
+//! Hilbert curve.
+template< typename T >
+insist_inline auto hilbert_range( T const (&stops)[2] )
+                                       -> detail::curve_range< T, curve::hilbert > {
+   T const starts[2] = { T{0}, T{0} };
+   T const steps[2] = { T{1}, T{1} };
+   return detail::make_curve_range< curve::hilbert >( starts, stops, steps );
+}
+
+//! The points of `range_nd( starts, stops, steps )`, along a Hilbert curve.
+template< typename T >
+insist_inline auto hilbert_range( T const (&starts)[2], T const (&stops)[2],
+                                  T const (&steps)[2] )
+                                       -> detail::curve_range< T, curve::hilbert > {
+   return detail::make_curve_range< curve::hilbert >( starts, stops, steps );
+}
+
+} // namespace estd
+
+#endif // RANGE_FN_CURVE_HXX_
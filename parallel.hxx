@@ -0,0 +1,704 @@
+//
+// Copyright 2018 Ghyslain Leclerc
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef RANGE_FN_PARALLEL_HXX_
+#define RANGE_FN_PARALLEL_HXX_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "range.hxx"
+
+
+namespace estd {
+
+
+//------------------------------------------------------------------------------
+//! @brief Fixed set of worker threads, created once and reused by every call to
+//! run (and thus to parallel_for).
+//!
+//! The thread calling run takes part in the work, so a pool of size `n` has
+//! `n - 1` worker threads.  Calls to run from different threads are
+//! serialized; a call from inside a task runs its tasks inline, on the calling
+//! worker.
+class thread_pool
+{
+public:
+   explicit thread_pool( std::size_t num_threads = default_size() ) {
+      auto const num_workers = ( num_threads > 1 ) ? num_threads - 1 : 0;
+      workers_.reserve( num_workers );
+      for( std::size_t idx{0}; idx != num_workers; ++idx ) {
+         workers_.emplace_back( [this] { work(); } );
+      }
+   }
+
+   thread_pool( thread_pool const& ) = delete;
+   thread_pool& operator=( thread_pool const& ) = delete;
+
+   ~thread_pool() {
+      {
+         std::lock_guard< std::mutex > lock{ mutex_ };
+         stop_ = true;
+      }
+      wake_.notify_all();
+      for( auto& worker : workers_ ) { worker.join(); }
+   }
+
+   //! Number of threads doing the work, including the one calling run.
+   auto size() const -> std::size_t {
+      return workers_.size() + 1;
+   }
+
+   //! Calls `task( idx )` for every idx in [0, num_tasks[ and returns once
+   //! they are all done.  The first exception thrown by a task is rethrown.
+   template< typename Task >
+   void run( std::size_t num_tasks, Task& task ) {
+      if( num_tasks == 0 ) { return; }
+      if( workers_.empty() || num_tasks == 1 || in_worker() ) {
+         for( std::size_t idx{0}; idx != num_tasks; ++idx ) { task( idx ); }
+         return;
+      }
+
+      std::lock_guard< std::mutex > serialize{ run_mutex_ };
+      {
+         std::unique_lock< std::mutex > lock{ mutex_ };
+         idle_.wait( lock, [this] { return active_ == 0; } );
+         call_ = &invoke< Task >;
+         context_ = &task;
+         num_tasks_ = num_tasks;
+         next_.store( 0, std::memory_order_relaxed );
+         error_ = nullptr;
+         ++generation_;
+      }
+      wake_.notify_all();
+
+      // The calling thread now works for the pool: nested calls run inline.
+      in_worker() = true;
+      drain();
+      in_worker() = false;
+
+      std::exception_ptr error;
+      {
+         std::unique_lock< std::mutex > lock{ mutex_ };
+         idle_.wait( lock, [this] { return active_ == 0; } );
+         error = error_;
+         error_ = nullptr;
+      }
+      if( error ) { std::rethrow_exception( error ); }
+   }
+
+   static auto default_size() -> std::size_t {
+      auto const hardware = std::thread::hardware_concurrency();
+      return ( hardware > 0 ) ? hardware : 1;
+   }
+
+private:
+   template< typename Task >
+   static void invoke( void* context, std::size_t idx ) {
+      ( *static_cast< Task* >( context ) )( idx );
+   }
+
+   //! True on the threads executing tasks of the pool.
+   static auto in_worker() -> bool& {
+      static thread_local bool flag{ false };
+      return flag;
+   }
+
+   void work() {
+      in_worker() = true;
+      std::uint64_t seen{0};
+      for( ;; ) {
+         {
+            std::unique_lock< std::mutex > lock{ mutex_ };
+            wake_.wait( lock, [&] { return stop_ || generation_ != seen; } );
+            if( stop_ ) { return; }
+            seen = generation_;
+            ++active_;
+         }
+         drain();
+         {
+            std::lock_guard< std::mutex > lock{ mutex_ };
+            --active_;
+         }
+         idle_.notify_all();
+      }
+   }
+
+   void drain() {
+      for( ;; ) {
+         auto const idx = next_.fetch_add( 1, std::memory_order_relaxed );
+         if( idx >= num_tasks_ ) { return; }
+         try {
+            call_( context_, idx );
+         } catch( ... ) {
+            std::lock_guard< std::mutex > lock{ mutex_ };
+            if( !error_ ) { error_ = std::current_exception(); }
+         }
+      }
+   }
+
+   std::vector< std::thread > workers_;
+   std::mutex run_mutex_;
+   std::mutex mutex_;
+   std::condition_variable wake_;
+   std::condition_variable idle_;
+   bool stop_{ false };
+   std::uint64_t generation_{0};
+   std::size_t active_{0};
+
+   void (*call_)( void*, std::size_t ){ nullptr };
+   void* context_{ nullptr };
+   std::size_t num_tasks_{0};
+   std::atomic< std::size_t > next_{0};
+   std::exception_ptr error_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Pool shared by the parallel algorithms when none is given, with one
+//! thread per hardware thread.  Created on first use.
+inline auto default_pool() -> thread_pool& {
+   static thread_pool pool;
+   return pool;
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief How parallel_for distributes the elements of a range to threads.
+//!
+//!   - chunked: the range is cut once in chunks of `grain` elements that
+//!     threads take in order.  Cheapest when every element costs the same.
+//!   - stealing: each thread recursively halves the part of the range it owns
+//!     down to `grain` elements, and idle threads steal the largest pending
+//!     halves from the others.  Balances irregular per element costs.
+//!   - dynamic: threads take the next `grain` elements from a shared_range
+//!     until it is exhausted (OpenMP `schedule(dynamic)`).
+//!   - guided: like dynamic, but chunks start large and shrink down to `grain`
+//!     elements (OpenMP `schedule(guided)`).
+enum class schedule : std::uint_fast8_t {
+   chunked,
+   stealing,
+   dynamic,
+   guided
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Hands out consecutive sub-ranges of a range to any number of threads.
+//!
+//! Each call to next is a single fetch_add on a shared ticket counter; the
+//! positions of chunk `k` are a fixed function of `k`, computed in O(1), so no
+//! lock and no compare-and-swap loop is needed.  Chunks have `chunk_size`
+//! elements (the last one can be smaller) unless a number of threads is given
+//! for guided chunks: each then takes about 1 / num_threads of what remains,
+//! never less than `chunk_size`.
+//!
+//! `Range` must provide size() and slice( first, last ), like Range.
+template< typename Range >
+class shared_range
+{
+public:
+   explicit shared_range( Range const& rng, std::size_t chunk_size = 1,
+                          std::size_t guided_threads = 0 ) :
+      rng_( rng ),
+      size_{ rng.size() },
+      chunk_size_{ std::max< std::size_t >( chunk_size, 1 ) },
+      ratio_{ 1.0 },
+      num_guided_{ 0 },
+      guided_end_{ 0 },
+      ticket_{ 0 } {
+      if( guided_threads > 1 && size_ > chunk_size_ * guided_threads ) {
+         // Chunk k starts at size * ( 1 - ratio^k ) and has about
+         // size * ratio^k / num_threads elements: geometric chunks are used
+         // while that is at least chunk_size.
+         ratio_ = 1.0 - 1.0 / static_cast< double >( guided_threads );
+         auto const smallest = static_cast< double >( chunk_size_ * guided_threads )
+                                 / static_cast< double >( size_ );
+         num_guided_ = static_cast< std::size_t >(
+            std::floor( std::log( smallest ) / std::log( ratio_ ) )
+         ) + 1;
+         guided_end_ = guided_start( num_guided_ );
+      }
+   }
+
+   shared_range( shared_range const& ) = delete;
+   shared_range& operator=( shared_range const& ) = delete;
+
+   //! Positions [first, last[ of the next chunk.  Returns false once the whole
+   //! range has been handed out.
+   auto next( std::size_t& first, std::size_t& last ) -> bool {
+      auto const ticket = ticket_.fetch_add( 1, std::memory_order_relaxed );
+      first = start( ticket );
+      last = start( ticket + 1 );
+      return first < last;
+   }
+
+   //! Next chunk, as a sub-range.  Returns false once the whole range has been
+   //! handed out.
+   auto next( Range& chunk ) -> bool {
+      std::size_t first{0};
+      std::size_t last{0};
+      if( !next( first, last ) ) { return false; }
+      chunk = rng_.slice( first, last );
+      return true;
+   }
+
+   //! The range being handed out.
+   auto range() const -> Range const& {
+      return rng_;
+   }
+
+private:
+   auto guided_start( std::size_t ticket ) const -> std::size_t {
+      auto const remaining = static_cast< double >( size_ )
+                              * std::pow( ratio_, static_cast< double >( ticket ) );
+      return size_ - std::min( size_, static_cast< std::size_t >( std::ceil( remaining ) ) );
+   }
+
+   auto start( std::size_t ticket ) const -> std::size_t {
+      if( ticket < num_guided_ ) { return guided_start( ticket ); }
+      auto const linear = ticket - num_guided_;
+      auto const left = size_ - guided_end_;
+      return ( linear >= ( left + chunk_size_ - 1 ) / chunk_size_ ) ?
+               size_ : guided_end_ + linear * chunk_size_;
+   }
+
+   Range const rng_;
+   std::size_t const size_;
+   std::size_t const chunk_size_;
+   double ratio_;
+   std::size_t num_guided_;
+   std::size_t guided_end_;
+   char padding_[ 64 ];
+   std::atomic< std::size_t > ticket_;
+   char ticket_padding_[ 64 - sizeof( std::atomic< std::size_t > ) ];
+};
+
+
+
+namespace detail {
+
+//! Enough chunks for a few per thread, to absorb some imbalance.
+inline auto default_grain( std::size_t size, std::size_t num_chunks_per_thread,
+                           std::size_t num_threads ) -> std::size_t {
+   auto const num_chunks = num_chunks_per_thread * num_threads;
+   return std::max< std::size_t >( 1, ( size + num_chunks - 1 ) / num_chunks );
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Positions [first, last[ of a range still to be processed.
+struct span
+{
+   std::size_t first;
+   std::size_t last;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Lock-free work-stealing deque (Chase and Lev), as formulated for
+//! C++11 atomics by Le, Pop, Cohen and Zappa Nardelli (PPoPP 2013).
+//!
+//! The owning thread pushes and takes at the bottom, other threads steal from
+//! the top.  The capacity is fixed: a thread only pushes the halves of the
+//! span it is splitting, so at most one span per halving is pending, i.e. no
+//! more than the number of bits of std::size_t.
+class stealing_deque
+{
+public:
+   static constexpr std::size_t capacity = 2 * 8 * sizeof( std::size_t );
+
+   stealing_deque() : top_{0}, bottom_{0} {
+   }
+
+   //! Owner only.
+   void push( span work ) {
+      auto const bottom = bottom_.load( std::memory_order_relaxed );
+      auto& slot = slots_[ bottom % capacity ];
+      slot.first.store( work.first, std::memory_order_relaxed );
+      slot.last.store( work.last, std::memory_order_relaxed );
+      std::atomic_thread_fence( std::memory_order_release );
+      bottom_.store( bottom + 1, std::memory_order_relaxed );
+   }
+
+   //! Owner only.  Most recently pushed span.
+   auto take( span& work ) -> bool {
+      auto const bottom = bottom_.load( std::memory_order_relaxed ) - 1;
+      bottom_.store( bottom, std::memory_order_relaxed );
+      std::atomic_thread_fence( std::memory_order_seq_cst );
+      auto top = top_.load( std::memory_order_relaxed );
+      if( top > bottom ) {
+         bottom_.store( bottom + 1, std::memory_order_relaxed );
+         return false;
+      }
+      work = read( bottom );
+      if( top == bottom ) {
+         auto const won = top_.compare_exchange_strong(
+            top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed
+         );
+         bottom_.store( bottom + 1, std::memory_order_relaxed );
+         return won;
+      }
+      return true;
+   }
+
+   //! Any thread.  Oldest pushed span, which is also the largest one.
+   auto steal( span& work ) -> bool {
+      auto top = top_.load( std::memory_order_acquire );
+      std::atomic_thread_fence( std::memory_order_seq_cst );
+      auto const bottom = bottom_.load( std::memory_order_acquire );
+      if( top >= bottom ) { return false; }
+      work = read( top );
+      return top_.compare_exchange_strong(
+         top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed
+      );
+   }
+
+private:
+   struct slot
+   {
+      std::atomic< std::size_t > first;
+      std::atomic< std::size_t > last;
+   };
+
+   auto read( std::ptrdiff_t idx ) const -> span {
+      auto const& slot = slots_[ static_cast< std::size_t >( idx ) % capacity ];
+      return span{
+         slot.first.load( std::memory_order_relaxed ),
+         slot.last.load( std::memory_order_relaxed )
+      };
+   }
+
+   // Signed, so that taking from an empty deque can go below zero.  Padded
+   // to keep thieves (top_) and owner (bottom_) on separate cache lines.
+   std::atomic< std::ptrdiff_t > top_;
+   char top_padding_[ 64 - sizeof( std::atomic< std::ptrdiff_t > ) ];
+   std::atomic< std::ptrdiff_t > bottom_;
+   char bottom_padding_[ 64 - sizeof( std::atomic< std::ptrdiff_t > ) ];
+   slot slots_[ capacity ];
+};
+
+
+
+//------------------------------------------------------------------------------
+template< typename Range, typename Function >
+void chunked_for( thread_pool& pool, Range const& rng, Function& fn,
+                  std::size_t grain ) {
+   auto const size = rng.size();
+   if( grain == 0 ) { grain = default_grain( size, 4, pool.size() ); }
+   auto const num_chunks = ( size + grain - 1 ) / grain;
+   auto chunk_task = [&]( std::size_t chunk ) {
+      auto const first = chunk * grain;
+      auto const last = std::min( first + grain, size );
+      for( auto&& val : rng.slice( first, last ) ) { fn( val ); }
+   };
+   pool.run( num_chunks, chunk_task );
+}
+
+
+
+//------------------------------------------------------------------------------
+template< typename Range, typename Function >
+void shared_for( thread_pool& pool, Range const& rng, Function& fn,
+                 std::size_t grain, std::size_t guided_threads ) {
+   if( grain == 0 ) {
+      grain = ( guided_threads > 0 ) ? 1 : default_grain( rng.size(), 16, pool.size() );
+   }
+   shared_range< Range > shared{ rng, grain, guided_threads };
+   auto worker_task = [&]( std::size_t ) {
+      std::size_t first{0};
+      std::size_t last{0};
+      while( shared.next( first, last ) ) {
+         for( auto&& val : rng.slice( first, last ) ) { fn( val ); }
+      }
+   };
+   pool.run( pool.size(), worker_task );
+}
+
+
+
+//------------------------------------------------------------------------------
+//! Runs one deque per thread of the pool.  The whole range starts in the first
+//! deque; everything else is obtained by stealing.
+template< typename Range, typename Function >
+void stealing_for( thread_pool& pool, Range const& rng, Function& fn,
+                   std::size_t grain ) {
+   auto const size = rng.size();
+   if( size == 0 ) { return; }
+   if( grain == 0 ) { grain = default_grain( size, 16, pool.size() ); }
+
+   auto const num_workers = pool.size();
+   std::vector< stealing_deque > deques( num_workers );
+   std::atomic< std::size_t > remaining{ size };
+   std::atomic< bool > failed{ false };
+   deques[0].push( span{ 0, size } );
+
+   auto worker_task = [&]( std::size_t self ) {
+      auto& own = deques[self];
+      auto victim = self;
+      span work;
+      while( remaining.load( std::memory_order_acquire ) != 0
+                  && !failed.load( std::memory_order_relaxed ) ) {
+         if( !own.take( work ) ) {
+            victim = ( victim + 1 ) % num_workers;
+            if( victim == self || !deques[victim].steal( work ) ) {
+               std::this_thread::yield();
+               continue;
+            }
+         }
+         while( work.last - work.first > grain ) {
+            auto const middle = work.first + ( work.last - work.first + 1 ) / 2;
+            own.push( span{ middle, work.last } );
+            work.last = middle;
+         }
+         try {
+            for( auto&& val : rng.slice( work.first, work.last ) ) { fn( val ); }
+         } catch( ... ) {
+            failed.store( true, std::memory_order_relaxed );
+            throw;
+         }
+         remaining.fetch_sub( work.last - work.first, std::memory_order_acq_rel );
+      }
+   };
+   pool.run( num_workers, worker_task );
+}
+
+} // namespace detail
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Calls `fn( value )` for every value of `rng`, in parallel on `pool`.
+//!
+//! `rng` only needs to be splittable, i.e. provide size() and an O(1)
+//! slice( first, last ), like Range.  It is processed in sub-ranges of at most
+//! `grain` elements (0 picks a value from the size of the range and of the
+//! pool), distributed according to `sched`.  Calls within a sub-range are in
+//! order, sub-ranges are not.
+template< typename Range, typename Function >
+void parallel_for( thread_pool& pool, Range const& rng, Function&& fn,
+                   std::size_t grain = 0, schedule sched = schedule::stealing ) {
+   switch( sched ) {
+      case schedule::chunked:
+         detail::chunked_for( pool, rng, fn, grain );
+         break;
+      case schedule::dynamic:
+         detail::shared_for( pool, rng, fn, grain, 0 );
+         break;
+      case schedule::guided:
+         detail::shared_for( pool, rng, fn, grain, pool.size() );
+         break;
+      case schedule::stealing:
+      default:
+         detail::stealing_for( pool, rng, fn, grain );
+         break;
+   }
+}
+
+template< typename Range, typename Function >
+void parallel_for( Range const& rng, Function&& fn, std::size_t grain = 0,
+                   schedule sched = schedule::stealing ) {
+   parallel_for( default_pool(), rng, std::forward< Function >( fn ), grain, sched );
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Order in which reduce and transform_reduce combine partial results.
+//!
+//!   - unordered: each thread accumulates whichever chunks it gets, then the
+//!     per thread results are combined.  Fastest, but for floating point
+//!     values the result can change from one run (or thread count) to the
+//!     next.
+//!   - fixed: the range is cut in blocks of `grain` elements whatever the
+//!     number of threads, and the block results are combined pairwise, always
+//!     in the same tree.  The result only depends on the range and the grain.
+enum class reduction_order : std::uint_fast8_t {
+   unordered,
+   fixed
+};
+
+
+
+namespace detail {
+
+//! Elements accumulated side by side within a chunk, so that the compiler can
+//! keep them in one or two vector registers.
+constexpr std::size_t reduce_lanes = 8;
+
+//! Block size of reduction_order::fixed when none is given.  Must not depend
+//! on the pool, or the result would.
+constexpr std::size_t fixed_reduce_grain = 4096;
+
+//------------------------------------------------------------------------------
+//! @brief Partial result of one thread (or block), alone on its cache lines.
+template< typename T >
+struct padded_partial
+{
+   T value;
+   bool used;
+   char padding[ 64 ];
+};
+
+//------------------------------------------------------------------------------
+//! Reduction of a non empty chunk in reduce_lanes independent accumulators,
+//! combined pairwise at the end.  The order only depends on the chunk size.
+template< typename T, typename Range, typename BinaryOp, typename UnaryOp >
+auto reduce_chunk( Range chunk, BinaryOp& op, UnaryOp& fn ) -> T {
+   auto const size = chunk.size();
+   auto const iter = chunk.begin();
+   std::size_t idx{0};
+   T result;
+   if( size < 2 * reduce_lanes ) {
+      result = fn( iter[0] );
+      idx = 1;
+   } else {
+      T lanes[ reduce_lanes ];
+      for( std::size_t lane{0}; lane != reduce_lanes; ++lane ) {
+         lanes[lane] = fn( iter[lane] );
+      }
+      for( idx = reduce_lanes; idx + reduce_lanes <= size; idx += reduce_lanes ) {
+         for( std::size_t lane{0}; lane != reduce_lanes; ++lane ) {
+            lanes[lane] = op( lanes[lane], fn( iter[idx + lane] ) );
+         }
+      }
+      for( auto width = reduce_lanes / 2; width != 0; width /= 2 ) {
+         for( std::size_t lane{0}; lane != width; ++lane ) {
+            lanes[lane] = op( lanes[lane], lanes[lane + width] );
+         }
+      }
+      result = lanes[0];
+   }
+   for( ; idx != size; ++idx ) { result = op( result, fn( iter[idx] ) ); }
+   return result;
+}
+
+//------------------------------------------------------------------------------
+template< typename T, typename Range, typename BinaryOp, typename UnaryOp >
+auto unordered_reduce( thread_pool& pool, Range const& rng, T init,
+                       BinaryOp& op, UnaryOp& fn, std::size_t grain ) -> T {
+   if( grain == 0 ) { grain = default_grain( rng.size(), 16, pool.size() ); }
+   shared_range< Range > shared{ rng, grain };
+   std::vector< padded_partial< T > > partials( pool.size() );
+   auto worker_task = [&]( std::size_t self ) {
+      auto& partial = partials[self];
+      std::size_t first{0};
+      std::size_t last{0};
+      while( shared.next( first, last ) ) {
+         auto const chunk = reduce_chunk< T >( rng.slice( first, last ), op, fn );
+         partial.value = partial.used ? op( partial.value, chunk ) : chunk;
+         partial.used = true;
+      }
+   };
+   pool.run( pool.size(), worker_task );
+   for( auto const& partial : partials ) {
+      if( partial.used ) { init = op( init, partial.value ); }
+   }
+   return init;
+}
+
+//------------------------------------------------------------------------------
+template< typename T, typename Range, typename BinaryOp, typename UnaryOp >
+auto fixed_reduce( thread_pool& pool, Range const& rng, T init,
+                   BinaryOp& op, UnaryOp& fn, std::size_t grain ) -> T {
+   auto const size = rng.size();
+   if( grain == 0 ) { grain = fixed_reduce_grain; }
+   auto const num_blocks = ( size + grain - 1 ) / grain;
+   std::vector< padded_partial< T > > blocks( num_blocks );
+   auto block_task = [&]( std::size_t block ) {
+      auto const first = block * grain;
+      blocks[block].value = reduce_chunk< T >(
+         rng.slice( first, std::min( first + grain, size ) ), op, fn
+      );
+   };
+   parallel_for( pool, estd::range( num_blocks ), block_task, 1 );
+   for( std::size_t width{1}; width < num_blocks; width *= 2 ) {
+      for( std::size_t idx{0}; idx + width < num_blocks; idx += 2 * width ) {
+         blocks[idx].value = op( blocks[idx].value, blocks[idx + width].value );
+      }
+   }
+   return op( init, blocks[0].value );
+}
+
+} // namespace detail
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Combines `init` and `fn( value )` for every value of `rng` with `op`,
+//! in parallel on `pool`.
+//!
+//! Like std::transform_reduce, `op` must be associative and commutative: the
+//! values are combined in chunks of `grain` elements (0 picks a value), and
+//! within a chunk in several interleaved accumulators.  `T` must be default
+//! constructible.  See reduction_order for reproducible floating point sums.
+template< typename Range, typename T, typename BinaryOp, typename UnaryOp >
+auto transform_reduce( thread_pool& pool, Range const& rng, T init, BinaryOp op,
+                       UnaryOp fn, std::size_t grain = 0,
+                       reduction_order order = reduction_order::unordered ) -> T {
+   if( rng.size() == 0 ) { return init; }
+   return ( order == reduction_order::fixed ) ?
+            detail::fixed_reduce( pool, rng, std::move( init ), op, fn, grain ) :
+            detail::unordered_reduce( pool, rng, std::move( init ), op, fn, grain );
+}
+
+template< typename Range, typename T, typename BinaryOp, typename UnaryOp >
+auto transform_reduce( Range const& rng, T init, BinaryOp op, UnaryOp fn,
+                       std::size_t grain = 0,
+                       reduction_order order = reduction_order::unordered ) -> T {
+   return estd::transform_reduce( default_pool(), rng, std::move( init ),
+                                  std::move( op ), std::move( fn ), grain, order );
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Combines `init` and every value of `rng` with `op` (a sum by default),
+//! in parallel on `pool`.  See transform_reduce.
+template< typename Range, typename T, typename BinaryOp = std::plus< T > >
+auto reduce( thread_pool& pool, Range const& rng, T init, BinaryOp op = BinaryOp{},
+             std::size_t grain = 0,
+             reduction_order order = reduction_order::unordered ) -> T {
+   return estd::transform_reduce( pool, rng, std::move( init ), std::move( op ),
+                                  []( T val ) { return val; }, grain, order );
+}
+
+template< typename Range, typename T, typename BinaryOp = std::plus< T > >
+auto reduce( Range const& rng, T init, BinaryOp op = BinaryOp{},
+             std::size_t grain = 0,
+             reduction_order order = reduction_order::unordered ) -> T {
+   return estd::reduce( default_pool(), rng, std::move( init ), std::move( op ),
+                        grain, order );
+}
+
+} // namespace estd
+
+#endif // RANGE_FN_PARALLEL_HXX_
@@ -17,8 +17,26 @@
 #ifndef RANGE_FN_RANGE_HXX_
 #define RANGE_FN_RANGE_HXX_
 
+#include <array>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// With C++20, ranges are also std::ranges views (see the end of this file).
+#if defined( __has_include )
+#  if __has_include( <version> )
+#     include <version>
+#  endif
+#endif
+#if defined( __cpp_lib_ranges )
+#  include <ranges>
+#  define RANGE_FN_STD_RANGES
+#endif
 
 
 // Macro to help with insisting on inlining with the compiler
@@ -48,6 +66,47 @@ behave as expected." \
 #endif // insist_inline
 
 
+// Functions that only return an expression are constexpr in every standard.
+// The others (local variables, loops, iterators moving) need the relaxed rules
+// of C++14 and are only constexpr from there on.
+#if !(defined(RANGE_FN_CONSTEXPR14))
+#  if defined( __cpp_constexpr ) && __cpp_constexpr >= 201304L
+#     define RANGE_FN_CONSTEXPR14 constexpr
+#  else
+#     define RANGE_FN_CONSTEXPR14
+#  endif
+#endif // RANGE_FN_CONSTEXPR14
+
+
+// Marks a branch that correct uses of the library never take, so that the
+// compiler can rely on it.
+#if !(defined(RANGE_FN_UNREACHABLE))
+#  if defined( __clang__ ) || defined( __GNUC__ )
+#     define RANGE_FN_UNREACHABLE() __builtin_unreachable()
+#  elif defined( _MSC_VER )
+#     define RANGE_FN_UNREACHABLE() __assume( 0 )
+#  else
+#     define RANGE_FN_UNREACHABLE() static_cast< void >( 0 )
+#  endif
+#endif // RANGE_FN_UNREACHABLE
+
+
+// Define RANGE_FN_USE_FMA to compute the values of floating point ranges with
+// std::fma( k, step, start ), rounding once instead of twice.  Only worth it
+// when the target has hardware FMA (e.g. -mfma), otherwise std::fma is a
+// library call.
+
+
+// materialize picks the widest of its AVX-512, AVX2 and baseline kernels the
+// running CPU supports, on x86 Linux with GCC or clang.  Define
+// RANGE_FN_NO_DISPATCH to always use the kernel built for the compiler flags.
+#if ( defined( __GNUC__ ) || defined( __clang__ ) )                            \
+      && ( defined( __x86_64__ ) || defined( __i386__ ) )                      \
+      && defined( __linux__ ) && !defined( RANGE_FN_NO_DISPATCH )
+#  define RANGE_FN_DISPATCH_X86
+#endif
+
+
 namespace estd {
 
 inline namespace cxx14 {
@@ -81,6 +140,79 @@ using remove_reference_t = typename ::std::remove_reference< T >::type;
 template< typename T >
 using remove_cv_t = typename ::std::remove_cv< T >::type;
 
+
+
+//------------------------------------------------------------------------------
+//! @brief Equivalent to [`std::integer_sequence`]
+//! (http://en.cppreference.com/w/cpp/utility/integer_sequence) in C++14 and up.
+//!
+//! As long as C++11 is the minimum supported version, this is necessary.
+template< typename T, T... values >
+struct integer_sequence {
+   using value_type = T;
+
+   static constexpr auto size() -> std::size_t {
+      return sizeof...( values );
+   }
+};
+
+template< std::size_t... values >
+using index_sequence = integer_sequence< std::size_t, values... >;
+
+}
+
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//! @brief The sequence [0, N[, built by halves so that the template recursion
+//! is only log2( N ) deep.
+template< typename First, typename Second >
+struct concat_sequences;
+
+template< typename T, T... first, T... second >
+struct concat_sequences< integer_sequence< T, first... >,
+                         integer_sequence< T, second... > > {
+   using type = integer_sequence<
+      T, first..., ( static_cast< T >( sizeof...( first ) ) + second )...
+   >;
+};
+
+template< typename T, std::size_t N >
+struct make_sequence {
+   using type = typename concat_sequences<
+      typename make_sequence< T, N / 2 >::type,
+      typename make_sequence< T, N - N / 2 >::type
+   >::type;
+};
+
+template< typename T >
+struct make_sequence< T, 0 > {
+   using type = integer_sequence< T >;
+};
+
+template< typename T >
+struct make_sequence< T, 1 > {
+   using type = integer_sequence< T, 0 >;
+};
+
+} // namespace detail
+
+
+inline namespace cxx14 {
+
+//------------------------------------------------------------------------------
+//! @brief Equivalent to [`std::make_integer_sequence`]
+//! (http://en.cppreference.com/w/cpp/utility/integer_sequence) in C++14 and up.
+//!
+//! As long as C++11 is the minimum supported version, this is necessary.
+template< typename T, T N >
+using make_integer_sequence =
+   typename detail::make_sequence< T, static_cast< std::size_t >( N ) >::type;
+
+template< std::size_t N >
+using make_index_sequence = make_integer_sequence< std::size_t, N >;
+
 }
 
 
@@ -109,6 +241,17 @@ using remove_cvref_t = typename ::estd::remove_cvref<T>::type;
 
 
 
+//------------------------------------------------------------------------------
+//! @brief Order in which range_nd visits its index tuples: the last axis
+//! varies fastest (`row_major`, as C arrays) or the first one does
+//! (`column_major`, as Fortran arrays).
+enum class layout : uint_fast8_t {
+   row_major,
+   column_major
+};
+
+
+
 namespace detail {
 
 
@@ -152,13 +295,17 @@ using is_allowed_step_type = std::integral_constant<
 
 
 //------------------------------------------------------------------------------
+//! @brief Direction of a range.  `runtime` means it is only known once the
+//! range is constructed.
 enum class Direction : uint_fast8_t {
    ascending,
-   descending
+   descending,
+   runtime
 };
 
 constexpr const auto Ascending = Direction::ascending;
 constexpr const auto Descending = Direction::descending;
+constexpr const auto Runtime = Direction::runtime;
 
 
 //------------------------------------------------------------------------------
@@ -171,251 +318,2066 @@ constexpr const auto Unit = Length::unit;
 constexpr const auto Other = Length::other;
 
 
+//------------------------------------------------------------------------------
+//! @brief Value of the element `n` steps away from `val` (`n` can be negative).
+template< typename T >
+insist_inline constexpr
+auto nth_value( T val, T step, std::ptrdiff_t n )
+                           -> enable_if_t< std::is_integral<T>::value, T > {
+   using unsigned_t = typename std::make_unsigned< T >::type;
+   return static_cast< T >(
+      static_cast< std::uintmax_t >( static_cast< unsigned_t >( val ) )
+      + static_cast< std::uintmax_t >( static_cast< unsigned_t >( step ) )
+         * static_cast< std::uintmax_t >( n )
+   );
+}
+
+//!
+//! Floating point values are always computed from a start value and an
+//! element count rather than accumulated, so they do not drift and are the
+//! same however they are reached.
+template< typename T >
+insist_inline constexpr
+auto nth_value( T val, T step, std::ptrdiff_t n )
+                           -> enable_if_t< std::is_floating_point<T>::value, T > {
+#if defined( __clang__ )
+   // clang decides on contraction here, where it sees the expression, and
+   // would fuse it in the materialize kernels built with FMA (GCC decides
+   // later, per function: see fill_values_avx2).
+#  pragma clang fp contract( off )
+#endif
+#if defined( RANGE_FN_USE_FMA )
+   return std::fma( static_cast< T >( n ), step, val );
+#else
+   return val + static_cast< T >( n ) * step;
+#endif
+}
+
+
 
 //------------------------------------------------------------------------------
-template< typename T, Length length, template< typename, Length > class Iterator >
-struct Dereference
-{
-public:
-   insist_inline
-   auto operator*() -> T& {
-      return static_cast< Iterator< T, length >& >(*this).cur_val_;
-   }
-};
+//! @brief Type in which range iterators accumulate values of `T`: signed
+//! types narrower than std::intmax_t are widened, so that moving past the
+//! last value of a range can not overflow.
+template< typename T >
+using accumulator_t = typename std::conditional<
+   std::is_integral< T >::value && std::is_signed< T >::value
+      && sizeof( T ) < sizeof( std::intmax_t ),
+   std::intmax_t, T
+>::type;
+
+//! @brief `val`, a value of `T` held in a wider type.  Only called on values
+//! of the range, so the compiler is told it fits: it then knows that the
+//! conversion does not change it, e.g. when the value is used as an index.
+//! The bounds are checked one at a time: GCC turns a combined check into an
+//! early exit of the loop, which it can not vectorize.
+template< typename T >
+insist_inline constexpr
+auto to_value( T val ) -> T {
+   return val;
+}
+
+template< typename T, typename Wide,
+          typename = enable_if_t< !std::is_same< T, Wide >::value > >
+insist_inline constexpr
+auto to_value( Wide val ) -> T {
+   return static_cast< T >(
+      ( val > std::numeric_limits< T >::max() ) ? ( RANGE_FN_UNREACHABLE(), val ) :
+      ( val < std::numeric_limits< T >::min() ) ? ( RANGE_FN_UNREACHABLE(), val ) : val
+   );
+}
 
 
 
 //------------------------------------------------------------------------------
-template< typename T, Length length, template< typename, Length > class Iterator >
-struct Increment
-{
-public:
-   template< typename Return = Iterator< T, length > >
-   insist_inline
-   auto operator++() -> enable_if_t< length == Unit, Return& > {
-      auto& self = static_cast<Iterator< T, length >&>(*this);
-      ( self.direction_ == Ascending ) ? ++(self.cur_val_): --(self.cur_val_);
-      return static_cast<Iterator< T, length >&>(*this);
-   }
+//! @brief `x` rounded up to an element count, `x` being positive (std::ceil is
+//! not constexpr).
+template< typename T >
+insist_inline constexpr
+auto ceil_count( T x ) -> std::size_t {
+   return ( static_cast< T >( static_cast< std::size_t >( x ) ) < x ) ?
+             static_cast< std::size_t >( x ) + 1 : static_cast< std::size_t >( x );
+}
 
-   template< typename Return = Iterator< T, length > >
-   insist_inline
-   auto operator++() -> enable_if_t< length == Other, Return& > {
-      static_cast<Iterator< T, length >&>(*this).cur_val_ +=
-                           static_cast<Iterator< T, length >&>(*this).step_;
-      return static_cast<Iterator< T, length >&>(*this);
+//! @brief Distance between `lo` and `hi`, where `lo < hi`, without overflow.
+template< typename T >
+insist_inline constexpr
+auto distance( T lo, T hi ) -> enable_if_t< std::is_integral<T>::value, std::size_t > {
+   using unsigned_t = typename std::make_unsigned< T >::type;
+   return static_cast< std::size_t >(
+      static_cast< unsigned_t >( static_cast< unsigned_t >( hi )
+                                    - static_cast< unsigned_t >( lo ) )
+   );
+}
+
+template< typename T >
+insist_inline constexpr
+auto distance( T lo, T hi ) -> enable_if_t< std::is_floating_point<T>::value, std::size_t > {
+   return ceil_count( hi - lo );
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Converts the user supplied step to the value type of the range.
+//!
+//! For integral ranges, the step goes through the signed counterpart of `T` so
+//! that a negative step is well defined even for unsigned ranges (it wraps).
+template< typename T, typename U >
+insist_inline constexpr
+auto to_step( U step ) -> enable_if_t< std::is_integral<T>::value, T > {
+   using signed_t = typename std::make_signed< T >::type;
+   return static_cast< T >( static_cast< signed_t >( step ) );
+}
+
+template< typename T, typename U >
+insist_inline constexpr
+auto to_step( U step ) -> enable_if_t< std::is_floating_point<T>::value, T > {
+   return static_cast< T >( step );
+}
+
+template< typename T >
+insist_inline constexpr
+auto unit_step( T start, T stop ) -> T {
+   return ( start < stop ) ? T{1} : to_step< T >( -1 );
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Number of elements in [start, stop[ when moving by one.
+//!
+//! With a compile time direction, bounds in the other order give an empty
+//! range.
+template< Direction direction, typename T >
+insist_inline constexpr
+auto unit_count( T start, T stop ) -> enable_if_t< direction == Runtime, std::size_t > {
+   return ( start < stop ) ? distance( start, stop ) : distance( stop, start );
+}
+
+template< Direction direction, typename T >
+insist_inline constexpr
+auto unit_count( T start, T stop ) -> enable_if_t< direction == Ascending, std::size_t > {
+   return ( start < stop ) ? distance( start, stop ) : 0;
+}
+
+template< Direction direction, typename T >
+insist_inline constexpr
+auto unit_count( T start, T stop ) -> enable_if_t< direction == Descending, std::size_t > {
+   return ( stop < start ) ? distance( stop, start ) : 0;
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Number of elements in [start, stop[ when moving by `step`.
+//!
+//! A step that goes away from `stop` (or a null step) gives an empty range.
+template< typename T >
+insist_inline RANGE_FN_CONSTEXPR14
+auto step_count( T start, T stop, T step )
+                  -> enable_if_t< std::is_integral<T>::value, std::size_t > {
+   using unsigned_t = typename std::make_unsigned< T >::type;
+   using signed_t = typename std::make_signed< T >::type;
+   auto const signed_step = static_cast< signed_t >( step );
+   std::size_t dist{0};
+   std::size_t magnitude{0};
+   if( start < stop && signed_step > 0 ) {
+      dist = distance( start, stop );
+      magnitude = static_cast< std::size_t >( signed_step );
+   } else if( stop < start && signed_step < 0 ) {
+      dist = distance( stop, start );
+      magnitude = static_cast< unsigned_t >(
+                     unsigned_t{0} - static_cast< unsigned_t >( signed_step ) );
+   } else {
+      return 0;
    }
-};
+   return dist / magnitude + ( ( dist % magnitude ) != 0 ? 1 : 0 );
+}
+
+template< typename T >
+insist_inline RANGE_FN_CONSTEXPR14
+auto step_count( T start, T stop, T step )
+                  -> enable_if_t< std::is_floating_point<T>::value, std::size_t > {
+   auto const quotient = ( stop - start ) / step;
+   return ( step != T{0} && quotient > T{0} ) ? ceil_count( quotient ) : 0;
+}
 
 
 
 //------------------------------------------------------------------------------
-template< typename T, Length length, template< typename, Length > class Iterator >
-struct StopCondition
+//! @brief Holds the step of a range or of its iterators.
+//!
+//! When the direction is known at compile time, the step is a constant and
+//! nothing is stored.
+template< typename T, Direction direction >
+struct Stride
 {
-   template< typename Return = bool >
-   insist_inline
-   auto operator==( Iterator< T, length > const& rhs ) const
-                  -> enable_if_t< !std::is_floating_point<T>::value
-                                             && ( length == Unit), Return > {
-      return static_cast<Iterator< T, length > const&>(*this).cur_val_ == rhs.cur_val_;
+public:
+   insist_inline constexpr
+   Stride() : step_{} {
    }
 
-   template< typename Return = bool >
-   insist_inline
-   auto operator==( Iterator< T, length > const& rhs ) const
-                  -> enable_if_t< std::is_floating_point<T>::value
-                                             || length == Other, Return > {
-      return ( static_cast<Iterator< T, length > const&>(*this).direction_ == Ascending ) ?
-               ( static_cast<Iterator< T, length > const&>(*this).cur_val_ >= rhs.cur_val_ ) :
-                  ( static_cast<Iterator< T, length > const&>(*this).cur_val_ <= rhs.cur_val_ );
+   insist_inline constexpr
+   explicit Stride( T step ) : step_{ step } {
    }
 
-   insist_inline
-   bool operator!=( Iterator< T, length > const& rhs ) const {
-      return !(*this == rhs);
+   insist_inline constexpr
+   auto step() const -> T {
+      return step_;
    }
-};
-
-
 
-//------------------------------------------------------------------------------
-template< typename T, Length length >
-struct range_iterator;
+private:
+   T step_;
+};
 
 
 template< typename T >
-struct range_iterator< T, Unit > :
-   Dereference< T, Unit, detail::range_iterator >,
-   Increment< T, Unit, detail::range_iterator >,
-   StopCondition< T, Unit, detail::range_iterator >
+struct Stride< T, Ascending >
 {
 public:
-   using value_type = T;
-   using reference = T&;
-   using iterator_category = std::input_iterator_tag;
-   using pointer = T*;
-   using difference_type = void;
+   Stride() = default;
 
-   insist_inline
-   range_iterator( T val, Direction dir )
-               : direction_{ dir }, cur_val_{ val } {
+   insist_inline constexpr
+   explicit Stride( T ) {
    }
-private:
-   Direction const direction_;
-   T cur_val_;
 
-   friend Dereference< T, Unit, detail::range_iterator >;
-   friend Increment< T, Unit, detail::range_iterator >;
-   friend StopCondition< T, Unit, detail::range_iterator >;
+   insist_inline constexpr
+   auto step() const -> T {
+      return T{1};
+   }
 };
 
 
 template< typename T >
-struct range_iterator< T, Other > :
-   Dereference< T, Other, detail::range_iterator >,
-   Increment< T, Other, detail::range_iterator >,
-   StopCondition< T, Other, detail::range_iterator >
+struct Stride< T, Descending >
 {
 public:
-   using value_type = T;
-   using reference = T&;
-   using iterator_category = std::input_iterator_tag;
-   using pointer = T*;
-   using difference_type = void;
+   Stride() = default;
 
-   insist_inline
-   range_iterator( T val, T step, Direction dir )
-               : direction_{ dir }, cur_val_{ val }, step_{ step } {
+   insist_inline constexpr
+   explicit Stride( T ) {
    }
-private:
-   Direction direction_;
-   T cur_val_;
-   T step_;
 
-   friend Dereference< T, Other, detail::range_iterator >;
-   friend Increment< T, Other, detail::range_iterator >;
-   friend StopCondition< T, Other, detail::range_iterator >;
+   insist_inline constexpr
+   auto step() const -> T {
+      return to_step< T >( -1 );
+   }
 };
 
 
 
 //------------------------------------------------------------------------------
-template< typename T, Length length, template< typename, Length > class Iterator >
-struct Range
+//! @brief Iterator of a Range: an element counter, the first value and the
+//! current value.
+//!
+//! The end of the iteration is decided by the counter, which keeps the loop
+//! countable, except for unit steps of an integral type: those land exactly on
+//! the end value, whatever the direction, so equality compares values instead
+//! and the loop reads like `for( i = b; i != e; ++i )`, with no counter to
+//! keep beside the value.
+//!
+//! Integral values are accumulated.  Floating point values are computed from
+//! the first value and the counter (see nth_value), so they do not drift.
+//!
+//! Values are returned by value: they are computed, and a reference to the
+//! one the iterator holds would dangle with std::reverse_iterator, which
+//! dereferences a temporary copy.  The value is kept up to date when moving
+//! rather than when dereferencing: a `mutable` member could not be read in a
+//! constant expression.
+//!
+//! What depends on `T` and `length` is chosen by tag dispatch on the private
+//! helpers below: a single class with plain overloads is much cheaper to
+//! instantiate, in every translation unit, than mixins with SFINAE'd members.
+template< typename T, Length length, Direction direction >
+struct range_iterator : Stride< T, direction >
 {
+   using accumulates = std::is_integral< T >;
+   using compares_values = std::integral_constant<
+      bool, std::is_integral< T >::value && length == Unit
+   >;
+   using stored = typename std::conditional<
+      length == Unit, T, accumulator_t< T >
+   >::type;
+   //! Adding the step can not overflow: unit steps end on the stop value,
+   //! wider types have room past the last value, unsigned types wrap.
+   using adds_step = std::integral_constant<
+      bool, length == Unit || !std::is_same< stored, T >::value
+            || std::is_unsigned< T >::value
+   >;
+
 public:
+   using value_type = T;
+   using reference = T;
+   using iterator_category = std::random_access_iterator_tag;
+   using pointer = void;
+   using difference_type = std::ptrdiff_t;
+#if defined( RANGE_FN_STD_RANGES )
+   using iterator_concept = std::random_access_iterator_tag;
+#endif
+
+   insist_inline constexpr
+   range_iterator() : index_{ 0 }, first_{}, cur_val_{} {
+   }
 
-   template< typename _ = void, typename = enable_if_t< length == Unit, _ > >
-   insist_inline
-   Range( T start, T stop ) :
-      direction_{ (start < stop) ? Ascending : Descending },
-      cur_val_{ start },
-      end_{ stop },
-      step_{1} {
-      static_assert(
-         is_allowed_range_type<T>::value,
-         "Only integers, characters and floating points are allowed in ranges."
-      );
+   //! Iterator on the element at position `idx` of the range starting at
+   //! `first`.
+   insist_inline constexpr
+   range_iterator( std::size_t idx, T first, T step )
+               : Stride< T, direction >{ step },
+                 index_{ idx },
+                 first_{ first },
+                 cur_val_{
+                    nth_value( first, step, static_cast< std::ptrdiff_t >( idx ) )
+                 } {
    }
 
-   template< typename U, typename _ = void, typename = enable_if_t< length == Other, _ > >
-   insist_inline Range( T start, T stop, U step ) :
-      direction_{ (start < stop) ? Direction::ascending : Direction::descending },
-      cur_val_{ start },
-      end_{ stop },
-      step_{ static_cast<T>(step) } {
-      static_assert(
-         detail::is_allowed_range_type<T>::value,
-         "Only integers, characters and floating points are allowed in ranges."
-      );
-      static_assert(
-         detail::is_allowed_step_type<U>::value,
-         "Only integers and floating point types are allowed as the step type."
+   insist_inline constexpr
+   auto operator*() const -> T {
+      return to_value< T >( cur_val_ );
+   }
+
+   insist_inline constexpr
+   auto operator[]( std::ptrdiff_t n ) const -> T {
+      return nth_value(
+         first_, this->step(), static_cast< std::ptrdiff_t >( index_ ) + n
       );
    }
 
-   template< typename Return = Iterator<T, length> >
-   insist_inline
-   auto begin() -> enable_if_t< length == Unit, Return > {
-      return Iterator< T, length >{ cur_val_, direction_ };
+   insist_inline RANGE_FN_CONSTEXPR14
+   auto operator++() -> range_iterator& {
+      ++index_;
+      next_value( accumulates{} );
+      return *this;
    }
 
-   template< typename Return = Iterator<T, length> >
-   insist_inline
-   auto begin() -> enable_if_t< length == Other, Return > {
-      return Iterator< T, length >{ cur_val_, step_, direction_ };
+   insist_inline RANGE_FN_CONSTEXPR14
+   auto operator++( int ) -> range_iterator {
+      auto copy = *this;
+      ++(*this);
+      return copy;
    }
 
-   template< typename Return = Iterator<T, length> >
-   insist_inline
-   auto end() -> enable_if_t< length == Unit, Return > {
-      return Iterator< T, length >{ end_, direction_ };
+   insist_inline RANGE_FN_CONSTEXPR14
+   auto operator--() -> range_iterator& {
+      return (*this) += -1;
    }
 
-   template< typename Return = Iterator<T, length> >
-   insist_inline
-   auto end() -> enable_if_t< length == Other, Return > {
-      return Iterator< T, length >{ end_, step_, direction_ };
+   insist_inline RANGE_FN_CONSTEXPR14
+   auto operator--( int ) -> range_iterator {
+      auto copy = *this;
+      --(*this);
+      return copy;
+   }
+
+   insist_inline RANGE_FN_CONSTEXPR14
+   auto operator+=( std::ptrdiff_t n ) -> range_iterator& {
+      index_ += static_cast< std::size_t >( n );
+      cur_val_ = nth_value( first_, this->step(), static_cast< std::ptrdiff_t >( index_ ) );
+      return *this;
+   }
+
+   insist_inline RANGE_FN_CONSTEXPR14
+   auto operator-=( std::ptrdiff_t n ) -> range_iterator& {
+      return (*this) += -n;
+   }
+
+   insist_inline RANGE_FN_CONSTEXPR14
+   friend auto operator+( range_iterator it, std::ptrdiff_t n ) -> range_iterator {
+      return it += n;
+   }
+
+   insist_inline RANGE_FN_CONSTEXPR14
+   friend auto operator+( std::ptrdiff_t n, range_iterator it ) -> range_iterator {
+      return it += n;
+   }
+
+   insist_inline RANGE_FN_CONSTEXPR14
+   friend auto operator-( range_iterator it, std::ptrdiff_t n ) -> range_iterator {
+      return it -= n;
+   }
+
+   insist_inline constexpr
+   auto operator-( range_iterator const& rhs ) const -> std::ptrdiff_t {
+      return static_cast< std::ptrdiff_t >( index_ - rhs.index_ );
+   }
+
+   insist_inline constexpr
+   bool operator==( range_iterator const& rhs ) const {
+      return same_position( rhs, compares_values{} );
+   }
+
+   insist_inline constexpr
+   bool operator!=( range_iterator const& rhs ) const {
+      return !same_position( rhs, compares_values{} );
+   }
+
+   insist_inline constexpr
+   bool operator<( range_iterator const& rhs ) const {
+      return index_ < rhs.index_;
+   }
+
+   insist_inline constexpr
+   bool operator>( range_iterator const& rhs ) const {
+      return rhs.index_ < index_;
+   }
+
+   insist_inline constexpr
+   bool operator<=( range_iterator const& rhs ) const {
+      return !( rhs.index_ < index_ );
+   }
+
+   insist_inline constexpr
+   bool operator>=( range_iterator const& rhs ) const {
+      return !( index_ < rhs.index_ );
    }
 
 private:
-   Direction const direction_;
-   T const cur_val_;
-   T const end_;
-   T const step_;
-};
+   insist_inline RANGE_FN_CONSTEXPR14
+   void next_value( std::true_type ) {
+      accumulate( adds_step{} );
+   }
 
+   insist_inline RANGE_FN_CONSTEXPR14
+   void next_value( std::false_type ) {
+      cur_val_ = nth_value( first_, this->step(), static_cast< std::ptrdiff_t >( index_ ) );
+   }
 
-template< typename T >
-using unit_range = Range< T, Unit, range_iterator >;
+   //! The value stays a plain induction variable for the compiler.
+   insist_inline RANGE_FN_CONSTEXPR14
+   void accumulate( std::true_type ) {
+      cur_val_ += this->step();
+   }
 
-template< typename T >
-using range = Range< T, Other, range_iterator >;
+   //! Signed values as wide as std::intmax_t can go past its largest (or
+   //! smallest) value after the last one: they wrap in the unsigned type, as
+   //! nth_value does.
+   insist_inline RANGE_FN_CONSTEXPR14
+   void accumulate( std::false_type ) {
+      cur_val_ = nth_value( cur_val_, this->step(), 1 );
+   }
 
+   insist_inline constexpr
+   bool same_position( range_iterator const& rhs, std::true_type ) const {
+      return cur_val_ == rhs.cur_val_;
+   }
 
-} // namespace detail
+   insist_inline constexpr
+   bool same_position( range_iterator const& rhs, std::false_type ) const {
+      return index_ == rhs.index_;
+   }
+
+   std::size_t index_;
+   T first_;
+   stored cur_val_;
+};
 
 
 
 //------------------------------------------------------------------------------
-template< typename T >
-insist_inline auto range( T start, T stop ) -> detail::unit_range< T > {
-   static_assert(
-      detail::is_allowed_range_type<T>::value,
-      "Only integers, characters and floating points are allowed in ranges."
-   );
-   return detail::unit_range<T>{ start, stop };
-}
+//! @brief Tag selecting the Range constructor that takes an element count.
+struct counted_t {};
 
 
 
 //------------------------------------------------------------------------------
-template< typename T >
-insist_inline auto range( T stop ) -> detail::unit_range< T > {
-   static_assert(
-      detail::is_allowed_range_type<T>::value,
-      "Only integers, characters and floating points are allowed in ranges."
-   );
-   return range( T{0}, stop );
-}
+//! @brief `W` consecutive values of a range, of which the first `count` are
+//! valid.  The other lanes (in the last batch only) repeat the last valid
+//! value, so that they remain usable as indices, e.g. in a gather.
+//!
+//! The values are aligned on their total size (up to a cache line), so they
+//! can be loaded in a vector register with an aligned load.
+template< typename T, std::size_t W >
+struct batch
+{
+   static_assert( W != 0 && ( W & ( W - 1 ) ) == 0,
+                  "The width of a batch must be a power of two." );
 
+   alignas( ( W * sizeof( T ) < 64 ) ? W * sizeof( T ) : 64 ) T values[ W ];
+   std::size_t count;
 
+   insist_inline
+   auto operator[]( std::size_t lane ) const -> T {
+      return values[lane];
+   }
 
-//------------------------------------------------------------------------------
-template< typename T, typename U >
-insist_inline auto range( T start, T stop, U step ) -> detail::range< T > {
-   static_assert(
-      detail::is_allowed_range_type<T>::value,
-      "Only integers, characters and floating points are allowed in ranges."
-   );
-   static_assert(
-      detail::is_allowed_step_type<U>::value,
-      "Only integers and floating point types are allowed as the step type."
-   );
-   return detail::range< T >{ start, stop, step };
-}
+   insist_inline
+   auto data() const -> T const* {
+      return values;
+   }
 
-} // namespace estd
+   //! True when every lane is valid.
+   insist_inline
+   auto full() const -> bool {
+      return count == W;
+   }
+
+   static constexpr auto size() -> std::size_t {
+      return W;
+   }
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Iterator on the batches of a range.
+//!
+//! It keeps the values of the current batch.  Integral lanes are moved by
+//! `W * step` at once, which is a single vector add; floating point lanes are
+//! recomputed from the first value (see nth_value), as in range_iterator.
+template< typename T, std::size_t W >
+struct batch_iterator
+{
+public:
+   using value_type = batch< T, W >;
+   using reference = batch< T, W >;
+   using iterator_category = std::input_iterator_tag;
+   using pointer = batch< T, W > const*;
+   using difference_type = std::ptrdiff_t;
+
+   insist_inline
+   batch_iterator() : index_{ 0 }, size_{ 0 }, first_{}, step_{}, lanes_{} {
+   }
+
+   insist_inline
+   batch_iterator( std::size_t idx, std::size_t size, T first, T step ) :
+      index_{ idx }, size_{ size }, first_{ first }, step_{ step }, lanes_{} {
+      set_lanes();
+   }
+
+   //! The current batch; lanes past the end of the range repeat its last
+   //! value.
+   insist_inline
+   auto operator*() const -> batch< T, W > {
+      batch< T, W > result;
+      result.count = ( size_ - index_ < W ) ? size_ - index_ : W;
+      for( std::size_t lane{0}; lane != W; ++lane ) {
+         result.values[lane] = lanes_.values[lane];
+      }
+      for( auto lane = result.count; lane < W; ++lane ) {
+         result.values[lane] = lanes_.values[ result.count - 1 ];
+      }
+      return result;
+   }
+
+   template< typename Return = batch_iterator >
+   insist_inline
+   auto operator++() -> enable_if_t< std::is_integral<T>::value, Return& > {
+      index_ += W;
+      for( std::size_t lane{0}; lane != W; ++lane ) {
+         lanes_.values[lane] = nth_value(
+            lanes_.values[lane], step_, static_cast< std::ptrdiff_t >( W )
+         );
+      }
+      return *this;
+   }
+
+   template< typename Return = batch_iterator >
+   insist_inline
+   auto operator++() -> enable_if_t< std::is_floating_point<T>::value, Return& > {
+      index_ += W;
+      set_lanes();
+      return *this;
+   }
+
+   insist_inline
+   auto operator++( int ) -> batch_iterator {
+      auto const previous = *this;
+      ++( *this );
+      return previous;
+   }
+
+   insist_inline
+   auto operator==( batch_iterator const& rhs ) const -> bool {
+      return index_ == rhs.index_;
+   }
+
+   insist_inline
+   auto operator!=( batch_iterator const& rhs ) const -> bool {
+      return !( *this == rhs );
+   }
+
+private:
+   insist_inline
+   void set_lanes() {
+      for( std::size_t lane{0}; lane != W; ++lane ) {
+         lanes_.values[lane] = nth_value(
+            first_, step_, static_cast< std::ptrdiff_t >( index_ + lane )
+         );
+      }
+   }
+
+   std::size_t index_;
+   std::size_t size_;
+   T first_;
+   T step_;
+   batch< T, W > lanes_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief The values of a range in batches of `W`.  Returned by
+//! Range::batched.
+template< typename T, std::size_t W >
+struct batched_range
+{
+public:
+   using iterator = batch_iterator< T, W >;
+
+   insist_inline
+   batched_range( T first, T step, std::size_t size ) :
+      first_{ first }, step_{ step }, size_{ size } {
+   }
+
+   insist_inline
+   auto begin() const -> iterator {
+      return iterator{ 0, size_, first_, step_ };
+   }
+
+   insist_inline
+   auto end() const -> iterator {
+      return iterator{ size() * W, size_, first_, step_ };
+   }
+
+   //! Number of batches, the last one possibly partial.
+   insist_inline
+   auto size() const -> std::size_t {
+      return ( size_ + W - 1 ) / W;
+   }
+
+   insist_inline
+   auto empty() const -> bool {
+      return size_ == 0;
+   }
+
+private:
+   T first_;
+   T step_;
+   std::size_t size_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Sub-range of `whole` at position `idx` among sub-ranges of `width`
+//! elements starting `step` elements apart; the last one can be shorter.
+template< typename Sub >
+insist_inline constexpr
+auto nth_chunk( Sub const& whole, std::size_t width, std::size_t step,
+                std::size_t idx ) -> Sub {
+   return whole.slice( idx * step, ( idx * step + width < whole.size() ) ?
+                                      idx * step + width : whole.size() );
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Iterator on the chunks or windows of a range.
+//!
+//! Only an index is moved and compared.  Chunks are built when dereferenced,
+//! so they are returned by value.
+template< typename Sub >
+struct chunk_iterator
+{
+public:
+   using value_type = Sub;
+   using reference = Sub;
+   using iterator_category = std::random_access_iterator_tag;
+   using pointer = void;
+   using difference_type = std::ptrdiff_t;
+
+   insist_inline
+   chunk_iterator() : whole_{}, width_{ 0 }, step_{ 0 }, idx_{ 0 } {
+   }
+
+   insist_inline
+   chunk_iterator( Sub whole, std::size_t width, std::size_t step, std::size_t idx ) :
+      whole_{ whole }, width_{ width }, step_{ step }, idx_{ idx } {
+   }
+
+   insist_inline
+   auto operator*() const -> Sub {
+      return nth_chunk( whole_, width_, step_, idx_ );
+   }
+
+   insist_inline
+   auto operator[]( std::ptrdiff_t n ) const -> Sub {
+      return nth_chunk( whole_, width_, step_, static_cast< std::size_t >(
+         static_cast< std::ptrdiff_t >( idx_ ) + n ) );
+   }
+
+   insist_inline
+   auto operator++() -> chunk_iterator& {
+      ++idx_;
+      return *this;
+   }
+
+   insist_inline
+   auto operator++( int ) -> chunk_iterator {
+      auto copy = *this;
+      ++idx_;
+      return copy;
+   }
+
+   insist_inline
+   auto operator--() -> chunk_iterator& {
+      --idx_;
+      return *this;
+   }
+
+   insist_inline
+   auto operator--( int ) -> chunk_iterator {
+      auto copy = *this;
+      --idx_;
+      return copy;
+   }
+
+   insist_inline
+   auto operator+=( std::ptrdiff_t n ) -> chunk_iterator& {
+      idx_ = static_cast< std::size_t >( static_cast< std::ptrdiff_t >( idx_ ) + n );
+      return *this;
+   }
+
+   insist_inline
+   auto operator-=( std::ptrdiff_t n ) -> chunk_iterator& {
+      return *this += -n;
+   }
+
+   insist_inline
+   friend auto operator+( chunk_iterator it, std::ptrdiff_t n ) -> chunk_iterator {
+      return it += n;
+   }
+
+   insist_inline
+   friend auto operator+( std::ptrdiff_t n, chunk_iterator it ) -> chunk_iterator {
+      return it += n;
+   }
+
+   insist_inline
+   friend auto operator-( chunk_iterator it, std::ptrdiff_t n ) -> chunk_iterator {
+      return it -= n;
+   }
+
+   insist_inline
+   auto operator-( chunk_iterator const& rhs ) const -> std::ptrdiff_t {
+      return static_cast< std::ptrdiff_t >( idx_ ) - static_cast< std::ptrdiff_t >( rhs.idx_ );
+   }
+
+   insist_inline
+   bool operator==( chunk_iterator const& rhs ) const {
+      return idx_ == rhs.idx_;
+   }
+
+   insist_inline
+   bool operator!=( chunk_iterator const& rhs ) const {
+      return idx_ != rhs.idx_;
+   }
+
+   insist_inline
+   bool operator<( chunk_iterator const& rhs ) const {
+      return idx_ < rhs.idx_;
+   }
+
+   insist_inline
+   bool operator>( chunk_iterator const& rhs ) const {
+      return idx_ > rhs.idx_;
+   }
+
+   insist_inline
+   bool operator<=( chunk_iterator const& rhs ) const {
+      return idx_ <= rhs.idx_;
+   }
+
+   insist_inline
+   bool operator>=( chunk_iterator const& rhs ) const {
+      return idx_ >= rhs.idx_;
+   }
+
+private:
+   Sub whole_;
+   std::size_t width_;
+   std::size_t step_;
+   std::size_t idx_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief `step`, or 1 for a null step, as tiled does for null extents.
+insist_inline constexpr
+auto nonzero_step( std::size_t step ) -> std::size_t {
+   return ( step > 0 ) ? step : 1;
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Consecutive sub-ranges of `width` elements of a range, starting
+//! `step` elements apart.  Returned by Range::chunks (`step == width`, the
+//! last chunk can be shorter) and Range::slide (`step == 1`, overlapping
+//! windows).
+//!
+//! Nothing is stored but the range and the three numbers, and each sub-range
+//! is a slice of it.  Like Range, it can be sliced and split, so it can be
+//! handed to parallel_for: each call of the body then gets a whole chunk.
+template< typename Sub >
+struct chunk_range
+{
+public:
+   using value_type = Sub;
+   using iterator = chunk_iterator< Sub >;
+
+   //! No sub-range.
+   insist_inline constexpr
+   chunk_range() : whole_{}, width_{ 0 }, step_{ 0 }, size_{ 0 } {
+   }
+
+   insist_inline constexpr
+   chunk_range( Sub whole, std::size_t width, std::size_t step, std::size_t count ) :
+      whole_{ whole }, width_{ width }, step_{ step }, size_{ count } {
+   }
+
+   insist_inline
+   auto begin() const -> iterator {
+      return iterator{ whole_, width_, step_, 0 };
+   }
+
+   insist_inline
+   auto end() const -> iterator {
+      return iterator{ whole_, width_, step_, size_ };
+   }
+
+   //! Number of sub-ranges.
+   insist_inline constexpr
+   auto size() const -> std::size_t {
+      return size_;
+   }
+
+   insist_inline constexpr
+   auto empty() const -> bool {
+      return size_ == 0;
+   }
+
+   insist_inline constexpr
+   auto front() const -> Sub {
+      return (*this)[0];
+   }
+
+   insist_inline constexpr
+   auto back() const -> Sub {
+      return (*this)[ size_ - 1 ];
+   }
+
+   //! Sub-range at position `idx`, without bounds checking.
+   insist_inline constexpr
+   auto operator[]( std::size_t idx ) const -> Sub {
+      return nth_chunk( whole_, width_, step_, idx );
+   }
+
+   //! Sub-ranges at positions [first, last[, as a chunk_range over the part
+   //! of the range they cover.
+   insist_inline RANGE_FN_CONSTEXPR14
+   auto slice( std::size_t first, std::size_t last ) const -> chunk_range {
+      auto const start = ( first * step_ < whole_.size() ) ? first * step_ : whole_.size();
+      auto const stop = ( last == first ) ? start : (*this)[ last - 1 ].size()
+                                                    + ( last - 1 ) * step_;
+      return chunk_range{ whole_.slice( start, stop ), width_, step_, last - first };
+   }
+
+   //! The two halves of the sub-ranges; the first one gets the middle one when
+   //! there is an odd number of them.
+   insist_inline RANGE_FN_CONSTEXPR14
+   auto split() const -> std::pair< chunk_range, chunk_range > {
+      return std::make_pair( slice( 0, ( size_ + 1 ) / 2 ), slice( ( size_ + 1 ) / 2, size_ ) );
+   }
+
+private:
+   Sub whole_;
+   std::size_t width_;
+   std::size_t step_;
+   std::size_t size_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Calls `fn` with the values at positions `idx + lane` of the range
+//! starting at `first`, one call after the other.  Used by Range::unrolled.
+template< typename T, typename Fn, std::size_t... lane >
+insist_inline RANGE_FN_CONSTEXPR14
+void unrolled_block( Fn& fn, T first, T step, std::size_t idx,
+                     index_sequence< lane... > ) {
+   int const expand[] = {
+      0, ( static_cast< void >( fn( nth_value(
+              first, step, static_cast< std::ptrdiff_t >( idx + lane ) ) ) ), 0 )...
+   };
+   static_cast< void >( expand );
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief The object returned by the range functions.
+//!
+//! The number of elements is computed once, on construction.  Iterators then
+//! only compare an element counter, so that a range based for loop has the
+//! same trip count the compiler sees in `for( size_t k{0}; k < n; ++k )`.
+//!
+//! `direction` is either fixed at compile time (unit steps only), in which
+//! case neither the range nor its iterators store a step, or `Runtime`.
+template<
+   typename T, Length length, Direction direction,
+   template< typename, Length, Direction > class Iterator
+>
+struct Range : Stride< T, direction >
+{
+   static_assert(
+      length == Unit || direction == Runtime,
+      "A direction fixed at compile time is only supported for unit steps."
+   );
+
+public:
+   using value_type = T;
+   using iterator = Iterator< T, length, direction >;
+
+   template< typename _ = void, typename = enable_if_t< length == Unit, _ > >
+   insist_inline constexpr
+   Range( T start, T stop ) :
+      Stride< T, direction >{ unit_step( start, stop ) },
+      cur_val_{ start },
+      size_{ unit_count< direction >( start, stop ) } {
+      static_assert(
+         is_allowed_range_type<T>::value,
+         "Only integers, characters and floating points are allowed in ranges."
+      );
+   }
+
+   template< typename U, typename _ = void, typename = enable_if_t< length == Other, _ > >
+   insist_inline constexpr Range( T start, T stop, U step ) :
+      Stride< T, direction >{ to_step< T >( step ) },
+      cur_val_{ start },
+      size_{ step_count( start, stop, to_step< T >( step ) ) } {
+      static_assert(
+         detail::is_allowed_range_type<T>::value,
+         "Only integers, characters and floating points are allowed in ranges."
+      );
+      static_assert(
+         detail::is_allowed_step_type<U>::value,
+         "Only integers and floating point types are allowed as the step type."
+      );
+   }
+
+   //! Empty range.
+   insist_inline constexpr
+   Range() : cur_val_{}, size_{ 0 } {
+   }
+
+   //! Range of `count` elements starting at `start` and moving by `step`
+   //! (ignored when the direction is fixed at compile time).
+   insist_inline constexpr
+   Range( T start, T step, std::size_t count, counted_t ) :
+      Stride< T, direction >{ step },
+      cur_val_{ start },
+      size_{ count } {
+   }
+
+   insist_inline constexpr
+   auto begin() const -> iterator {
+      return iterator{ 0, cur_val_, this->step() };
+   }
+
+   insist_inline constexpr
+   auto end() const -> iterator {
+      return iterator{ size_, cur_val_, this->step() };
+   }
+
+   //! Number of elements in the range.
+   insist_inline constexpr
+   auto size() const -> std::size_t {
+      return size_;
+   }
+
+   insist_inline constexpr
+   auto empty() const -> bool {
+      return size_ == 0;
+   }
+
+   //! First element.  The range must not be empty.
+   insist_inline constexpr
+   auto front() const -> T {
+      return cur_val_;
+   }
+
+   //! Last element.  The range must not be empty.
+   insist_inline constexpr
+   auto back() const -> T {
+      return (*this)[ size_ - 1 ];
+   }
+
+   //! Element at position `idx`, without bounds checking.
+   insist_inline constexpr
+   auto operator[]( std::size_t idx ) const -> T {
+      return nth_value( cur_val_, this->step(), static_cast< std::ptrdiff_t >( idx ) );
+   }
+
+   //! Elements at positions [first, last[, as a range of the same type.
+   insist_inline constexpr
+   auto slice( std::size_t first, std::size_t last ) const -> Range {
+      return Range{ (*this)[first], this->step(), last - first, counted_t{} };
+   }
+
+   //! The two halves of the range; the first one gets the middle element when
+   //! the size is odd.
+   insist_inline RANGE_FN_CONSTEXPR14
+   auto split() const -> std::pair< Range, Range > {
+      return split( 1, 1 );
+   }
+
+   //! The range split in two parts whose sizes are in the proportion
+   //! `left`:`right` (rounded).  With no proportion at all (`0:0`), the first
+   //! part is the whole range.
+   insist_inline RANGE_FN_CONSTEXPR14
+   auto split( std::size_t left, std::size_t right ) const
+                                          -> std::pair< Range, Range > {
+      auto const middle = ( left + right == 0 ) ? size_ : static_cast< std::size_t >(
+         ( static_cast< long double >( size_ ) * left ) / ( left + right ) + 0.5L
+      );
+      return std::make_pair( slice( 0, middle ), slice( middle, size_ ) );
+   }
+
+   //! Calls `fn` with each value, in order, `N` calls per loop iteration then
+   //! one per remaining value: the loop is unrolled whether the compiler
+   //! would have done it or not.
+   template< std::size_t N, typename Fn >
+   insist_inline RANGE_FN_CONSTEXPR14
+   void unrolled( Fn&& fn ) const {
+      static_assert( N != 0, "A loop can not be unrolled zero times." );
+      auto const whole = size_ - size_ % N;
+      std::size_t idx{0};
+      for( ; idx != whole; idx += N ) {
+         unrolled_block( fn, cur_val_, this->step(), idx, make_index_sequence< N >{} );
+      }
+      for( ; idx != size_; ++idx ) {
+         fn( (*this)[idx] );
+      }
+   }
+
+   //! The values of the range in batches of `W` (a power of two, e.g. the
+   //! number of lanes of a vector register).
+   template< std::size_t W >
+   insist_inline
+   auto batched() const -> batched_range< T, W > {
+      return batched_range< T, W >{ cur_val_, this->step(), size_ };
+   }
+
+   //! The range in consecutive chunks of `k` elements (1 when `k` is zero),
+   //! the last one possibly shorter.  Each chunk is a range of the same type.
+   insist_inline constexpr
+   auto chunks( std::size_t k ) const -> chunk_range< Range > {
+      return chunk_range< Range >{
+         *this, nonzero_step( k ), nonzero_step( k ),
+         ( size_ + nonzero_step( k ) - 1 ) / nonzero_step( k )
+      };
+   }
+
+   //! Every window of `k` consecutive elements (not zero), each one starting
+   //! an element after the previous one; none when the range is shorter.
+   insist_inline constexpr
+   auto slide( std::size_t k ) const -> chunk_range< Range > {
+      return chunk_range< Range >{ *this, k, 1, ( size_ < k ) ? 0 : size_ - k + 1 };
+   }
+
+private:
+   T cur_val_;
+   std::size_t size_;
+};
+
+
+template< typename T >
+using unit_range = Range< T, Unit, Runtime, range_iterator >;
+
+template< typename T >
+using range = Range< T, Other, Runtime, range_iterator >;
+
+template< typename T >
+using up_range = Range< T, Unit, Ascending, range_iterator >;
+
+template< typename T >
+using down_range = Range< T, Unit, Descending, range_iterator >;
+
+//! Range from zero: unsigned types can only go up.
+template< typename T >
+using zero_based_range = typename std::conditional<
+   std::is_unsigned< T >::value, up_range< T >, unit_range< T >
+>::type;
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Iterator yielding `scale * base^x` for each `x` of a floating point
+//! range.
+//!
+//! Moves and compares the range_iterator over the exponents it wraps, only
+//! dereferencing differs.  Values are computed, so they are returned by value.
+template< typename T, Length length, Direction direction >
+struct power_iterator
+{
+   using exponent_iterator = range_iterator< T, length, direction >;
+
+public:
+   using value_type = T;
+   using reference = T;
+   using iterator_category = std::random_access_iterator_tag;
+   using pointer = void;
+   using difference_type = std::ptrdiff_t;
+
+   insist_inline
+   power_iterator() : exponent_{}, base_{}, scale_{} {
+   }
+
+   insist_inline
+   power_iterator( std::size_t idx, T first, T step, T base, T scale )
+               : exponent_{ idx, first, step },
+                 base_{ base },
+                 scale_{ scale } {
+   }
+
+   insist_inline
+   auto operator*() const -> T {
+      return scale_ * std::pow( base_, *exponent_ );
+   }
+
+   insist_inline
+   auto operator[]( std::ptrdiff_t n ) const -> T {
+      return scale_ * std::pow( base_, exponent_[n] );
+   }
+
+   insist_inline
+   auto operator++() -> power_iterator& {
+      ++exponent_;
+      return *this;
+   }
+
+   insist_inline
+   auto operator++( int ) -> power_iterator {
+      auto copy = *this;
+      ++exponent_;
+      return copy;
+   }
+
+   insist_inline
+   auto operator--() -> power_iterator& {
+      --exponent_;
+      return *this;
+   }
+
+   insist_inline
+   auto operator--( int ) -> power_iterator {
+      auto copy = *this;
+      --exponent_;
+      return copy;
+   }
+
+   insist_inline
+   auto operator+=( std::ptrdiff_t n ) -> power_iterator& {
+      exponent_ += n;
+      return *this;
+   }
+
+   insist_inline
+   auto operator-=( std::ptrdiff_t n ) -> power_iterator& {
+      exponent_ -= n;
+      return *this;
+   }
+
+   insist_inline
+   friend auto operator+( power_iterator it, std::ptrdiff_t n ) -> power_iterator {
+      return it += n;
+   }
+
+   insist_inline
+   friend auto operator+( std::ptrdiff_t n, power_iterator it ) -> power_iterator {
+      return it += n;
+   }
+
+   insist_inline
+   friend auto operator-( power_iterator it, std::ptrdiff_t n ) -> power_iterator {
+      return it -= n;
+   }
+
+   insist_inline
+   auto operator-( power_iterator const& rhs ) const -> std::ptrdiff_t {
+      return exponent_ - rhs.exponent_;
+   }
+
+   insist_inline
+   bool operator==( power_iterator const& rhs ) const {
+      return exponent_ == rhs.exponent_;
+   }
+
+   insist_inline
+   bool operator!=( power_iterator const& rhs ) const {
+      return exponent_ != rhs.exponent_;
+   }
+
+   insist_inline
+   bool operator<( power_iterator const& rhs ) const {
+      return exponent_ < rhs.exponent_;
+   }
+
+   insist_inline
+   bool operator>( power_iterator const& rhs ) const {
+      return exponent_ > rhs.exponent_;
+   }
+
+   insist_inline
+   bool operator<=( power_iterator const& rhs ) const {
+      return exponent_ <= rhs.exponent_;
+   }
+
+   insist_inline
+   bool operator>=( power_iterator const& rhs ) const {
+      return exponent_ >= rhs.exponent_;
+   }
+
+private:
+   exponent_iterator exponent_;
+   T base_;
+   T scale_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Range of `scale * base^x` for each `x` of a floating point range of
+//! exponents.  Returned by logspace and geomspace.
+template< typename T >
+struct power_range
+{
+   static_assert(
+      std::is_floating_point< T >::value,
+      "Only floating points are allowed in logspace and geomspace."
+   );
+
+public:
+   using iterator = power_iterator< T, Other, Runtime >;
+
+   insist_inline
+   power_range() : exponents_{}, base_{}, scale_{} {
+   }
+
+   insist_inline
+   power_range( range< T > exponents, T base, T scale ) :
+      exponents_{ exponents }, base_{ base }, scale_{ scale } {
+   }
+
+   insist_inline
+   auto begin() const -> iterator {
+      return iterator{ 0, exponents_.front(), exponents_.step(), base_, scale_ };
+   }
+
+   insist_inline
+   auto end() const -> iterator {
+      return iterator{
+         exponents_.size(), exponents_.front(), exponents_.step(), base_, scale_
+      };
+   }
+
+   insist_inline
+   auto size() const -> std::size_t {
+      return exponents_.size();
+   }
+
+   insist_inline
+   auto empty() const -> bool {
+      return exponents_.empty();
+   }
+
+   insist_inline
+   auto front() const -> T {
+      return (*this)[0];
+   }
+
+   insist_inline
+   auto back() const -> T {
+      return (*this)[ size() - 1 ];
+   }
+
+   insist_inline
+   auto operator[]( std::size_t idx ) const -> T {
+      return scale_ * std::pow( base_, exponents_[idx] );
+   }
+
+private:
+   range< T > exponents_;
+   T base_;
+   T scale_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief First value, step and number of values along each axis of an
+//! nd_range.
+template< typename T, std::size_t N >
+struct nd_axes
+{
+   std::array< T, N > firsts;
+   std::array< T, N > steps;
+   std::array< std::size_t, N > counts;
+
+   //! Number of index tuples.
+   insist_inline
+   auto size() const -> std::size_t {
+      return product( std::integral_constant< std::size_t, 0 >{} );
+   }
+
+private:
+   template< std::size_t axis >
+   insist_inline
+   auto product( std::integral_constant< std::size_t, axis > ) const -> std::size_t {
+      return counts[axis] * product( std::integral_constant< std::size_t, axis + 1 >{} );
+   }
+
+   insist_inline
+   auto product( std::integral_constant< std::size_t, N > ) const -> std::size_t {
+      return 1;
+   }
+};
+
+//! Axis that varies `rank`-th fastest.
+template< layout order, std::size_t N >
+constexpr auto nd_axis( std::size_t rank ) -> std::size_t {
+   return ( order == layout::row_major ) ? N - 1 - rank : rank;
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Iterator on the index tuples of an nd_range.
+//!
+//! Like range_iterator, it moves a single flat counter, which is all that is
+//! compared.  The per axis counters are carried on increment, as nested loops
+//! would, and recomputed with divisions on any other move.
+template< typename T, std::size_t N, layout order >
+struct nd_iterator
+{
+public:
+   using value_type = std::array< T, N >;
+   using reference = std::array< T, N >;
+   using iterator_category = std::random_access_iterator_tag;
+   using pointer = std::array< T, N > const*;
+   using difference_type = std::ptrdiff_t;
+
+   insist_inline
+   nd_iterator() : axes_{}, index_{ 0 }, coords_{}, values_{} {
+   }
+
+   //! Iterator on the tuple at flat position `idx`.
+   insist_inline
+   nd_iterator( std::size_t idx, nd_axes< T, N > const& axes ) :
+      axes_( axes ), index_{ idx }, coords_{}, values_{} {
+      seek();
+   }
+
+   insist_inline
+   auto operator*() const -> std::array< T, N > {
+      return values_;
+   }
+
+   insist_inline
+   auto operator[]( std::ptrdiff_t n ) const -> std::array< T, N > {
+      return *( *this + n );
+   }
+
+   insist_inline
+   auto operator++() -> nd_iterator& {
+      ++index_;
+      auto const fastest = nd_axis< order, N >( 0 );
+      if( ++coords_[fastest] != axes_.counts[fastest] ) {
+         set_value( fastest );
+      } else {
+         carry( std::integral_constant< std::size_t, 0 >{} );
+      }
+      return *this;
+   }
+
+   insist_inline
+   auto operator++( int ) -> nd_iterator {
+      auto copy = *this;
+      ++( *this );
+      return copy;
+   }
+
+   insist_inline
+   auto operator--() -> nd_iterator& {
+      --index_;
+      seek();
+      return *this;
+   }
+
+   insist_inline
+   auto operator--( int ) -> nd_iterator {
+      auto copy = *this;
+      --( *this );
+      return copy;
+   }
+
+   insist_inline
+   auto operator+=( std::ptrdiff_t n ) -> nd_iterator& {
+      index_ += static_cast< std::size_t >( n );
+      seek();
+      return *this;
+   }
+
+   insist_inline
+   auto operator-=( std::ptrdiff_t n ) -> nd_iterator& {
+      return *this += -n;
+   }
+
+   insist_inline
+   friend auto operator+( nd_iterator iter, std::ptrdiff_t n ) -> nd_iterator {
+      return iter += n;
+   }
+
+   insist_inline
+   friend auto operator+( std::ptrdiff_t n, nd_iterator iter ) -> nd_iterator {
+      return iter += n;
+   }
+
+   insist_inline
+   friend auto operator-( nd_iterator iter, std::ptrdiff_t n ) -> nd_iterator {
+      return iter -= n;
+   }
+
+   insist_inline
+   auto operator-( nd_iterator const& rhs ) const -> std::ptrdiff_t {
+      return static_cast< std::ptrdiff_t >( index_ - rhs.index_ );
+   }
+
+   insist_inline
+   auto operator==( nd_iterator const& rhs ) const -> bool {
+      return index_ == rhs.index_;
+   }
+
+   insist_inline
+   auto operator!=( nd_iterator const& rhs ) const -> bool {
+      return index_ != rhs.index_;
+   }
+
+   insist_inline
+   auto operator<( nd_iterator const& rhs ) const -> bool {
+      return index_ < rhs.index_;
+   }
+
+   insist_inline
+   auto operator>( nd_iterator const& rhs ) const -> bool {
+      return rhs < *this;
+   }
+
+   insist_inline
+   auto operator<=( nd_iterator const& rhs ) const -> bool {
+      return !( rhs < *this );
+   }
+
+   insist_inline
+   auto operator>=( nd_iterator const& rhs ) const -> bool {
+      return !( *this < rhs );
+   }
+
+private:
+   insist_inline
+   void set_value( std::size_t axis ) {
+      values_[axis] = nth_value( axes_.firsts[axis], axes_.steps[axis],
+                                 static_cast< std::ptrdiff_t >( coords_[axis] ) );
+   }
+
+   // The axes are walked by recursion on their rank rather than by a loop, so
+   // that every array element is accessed at a constant position and the
+   // compiler can keep the iterator in registers.
+
+   //! Wraps the axis of rank `rank` around and moves the next one, like the
+   //! end of an inner loop.
+   template< std::size_t rank >
+   insist_inline
+   void carry( std::integral_constant< std::size_t, rank > ) {
+      coords_[ nd_axis< order, N >( rank ) ] = 0;
+      set_value( nd_axis< order, N >( rank ) );
+      auto const next = nd_axis< order, N >( rank + 1 );
+      if( ++coords_[next] != axes_.counts[next] ) {
+         set_value( next );
+      } else {
+         carry( std::integral_constant< std::size_t, rank + 1 >{} );
+      }
+   }
+
+   //! The slowest axis wraps around at the end of the range.
+   insist_inline
+   void carry( std::integral_constant< std::size_t, N - 1 > ) {
+      coords_[ nd_axis< order, N >( N - 1 ) ] = 0;
+      set_value( nd_axis< order, N >( N - 1 ) );
+   }
+
+   //! Per axis counters and values from the flat counter.
+   insist_inline
+   void seek() {
+      if( axes_.size() != 0 ) {
+         seek( std::integral_constant< std::size_t, 0 >{}, index_ );
+      }
+   }
+
+   template< std::size_t rank >
+   insist_inline
+   void seek( std::integral_constant< std::size_t, rank >, std::size_t rest ) {
+      auto const axis = nd_axis< order, N >( rank );
+      coords_[axis] = rest % axes_.counts[axis];
+      set_value( axis );
+      seek( std::integral_constant< std::size_t, rank + 1 >{}, rest / axes_.counts[axis] );
+   }
+
+   insist_inline
+   void seek( std::integral_constant< std::size_t, N >, std::size_t ) {
+   }
+
+   nd_axes< T, N > axes_;
+   std::size_t index_;
+   std::array< std::size_t, N > coords_;
+   std::array< T, N > values_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Cartesian product of `N` ranges, as std::array index tuples in
+//! `order`.  Returned by range_nd.
+//!
+//! The tuples are numbered by a single flat position, so the whole iteration
+//! space can be sliced and split like a Range, e.g. by parallel_for.
+template< typename T, std::size_t N, layout order >
+struct nd_range
+{
+public:
+   using iterator = nd_iterator< T, N, order >;
+
+   insist_inline
+   explicit nd_range( nd_axes< T, N > const& axes ) :
+      axes_( axes ), first_{ 0 }, size_{ axes.size() } {
+   }
+
+   //! The `size` tuples from flat position `first`.
+   insist_inline
+   nd_range( nd_axes< T, N > const& axes, std::size_t first, std::size_t size ) :
+      axes_( axes ), first_{ first }, size_{ size } {
+   }
+
+   insist_inline
+   auto begin() const -> iterator {
+      return iterator{ first_, axes_ };
+   }
+
+   insist_inline
+   auto end() const -> iterator {
+      return iterator{ first_ + size_, axes_ };
+   }
+
+   //! Number of index tuples.
+   insist_inline
+   auto size() const -> std::size_t {
+      return size_;
+   }
+
+   insist_inline
+   auto empty() const -> bool {
+      return size_ == 0;
+   }
+
+   //! Number of values along each axis.
+   insist_inline
+   auto extents() const -> std::array< std::size_t, N > {
+      return axes_.counts;
+   }
+
+   //! First value, step and number of values of each axis.
+   insist_inline
+   auto axes() const -> nd_axes< T, N > const& {
+      return axes_;
+   }
+
+   //! First tuple.  The range must not be empty.
+   insist_inline
+   auto front() const -> std::array< T, N > {
+      return (*this)[0];
+   }
+
+   //! Last tuple.  The range must not be empty.
+   insist_inline
+   auto back() const -> std::array< T, N > {
+      return (*this)[ size_ - 1 ];
+   }
+
+   //! Tuple at position `idx`, without bounds checking.
+   insist_inline
+   auto operator[]( std::size_t idx ) const -> std::array< T, N > {
+      return *iterator{ first_ + idx, axes_ };
+   }
+
+   //! Tuples at positions [first, last[, as a range of the same type.
+   insist_inline
+   auto slice( std::size_t first, std::size_t last ) const -> nd_range {
+      return nd_range{ axes_, first_ + first, last - first };
+   }
+
+   //! The two halves of the range; the first one gets the middle tuple when
+   //! the size is odd.
+   insist_inline
+   auto split() const -> std::pair< nd_range, nd_range > {
+      auto const middle = size_ - size_ / 2;
+      return std::make_pair( slice( 0, middle ), slice( middle, size_ ) );
+   }
+
+private:
+   nd_axes< T, N > axes_;
+   std::size_t first_;
+   std::size_t size_;
+};
+
+
+} // namespace detail
+
+
+
+//------------------------------------------------------------------------------
+template< typename T >
+insist_inline constexpr auto range( T start, T stop ) -> detail::unit_range< T > {
+   static_assert(
+      detail::is_allowed_range_type<T>::value,
+      "Only integers, characters and floating points are allowed in ranges."
+   );
+   return detail::unit_range<T>{ start, stop };
+}
+
+
+
+//------------------------------------------------------------------------------
+template< typename T >
+insist_inline constexpr auto range( T stop ) -> detail::zero_based_range< T > {
+   static_assert(
+      detail::is_allowed_range_type<T>::value,
+      "Only integers, characters and floating points are allowed in ranges."
+   );
+   return detail::zero_based_range< T >{ T{0}, stop };
+}
+
+
+
+//------------------------------------------------------------------------------
+template< typename T, typename U >
+insist_inline RANGE_FN_CONSTEXPR14
+auto range( T start, T stop, U step ) -> detail::range< T > {
+   static_assert(
+      detail::is_allowed_range_type<T>::value,
+      "Only integers, characters and floating points are allowed in ranges."
+   );
+   static_assert(
+      detail::is_allowed_step_type<U>::value,
+      "Only integers and floating point types are allowed as the step type."
+   );
+   return detail::range< T >{ start, stop, step };
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Range that can only go up: [start, stop[ is empty if stop <= start.
+//!
+//! The direction being known at compile time, neither the range nor its
+//! iterators carry a step and moving forward is a plain increment.
+template< typename T >
+insist_inline constexpr auto up_range( T start, T stop ) -> detail::up_range< T > {
+   static_assert(
+      detail::is_allowed_range_type<T>::value,
+      "Only integers, characters and floating points are allowed in ranges."
+   );
+   return detail::up_range< T >{ start, stop };
+}
+
+template< typename T >
+insist_inline constexpr auto up_range( T stop ) -> detail::up_range< T > {
+   return up_range( T{0}, stop );
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Range that can only go down: [start, stop[ is empty if
+//! start <= stop.
+template< typename T >
+insist_inline constexpr auto down_range( T start, T stop ) -> detail::down_range< T > {
+   static_assert(
+      detail::is_allowed_range_type<T>::value,
+      "Only integers, characters and floating points are allowed in ranges."
+   );
+   return detail::down_range< T >{ start, stop };
+}
+
+
+
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//! @brief Number of values of static_range< first, last, step >, counted as
+//! step_count does.
+constexpr auto static_count( std::ptrdiff_t first, std::ptrdiff_t last,
+                             std::ptrdiff_t step ) -> std::size_t {
+   return ( step > 0 && first < last ) ?
+             static_cast< std::size_t >( ( last - first + step - 1 ) / step ) :
+          ( step < 0 && last < first ) ?
+             static_cast< std::size_t >( ( first - last - step - 1 ) / -step ) :
+          0;
+}
+
+//! @brief The values `first + k * step` for each `k` of `Indices`.
+template< std::ptrdiff_t first, std::ptrdiff_t step, typename Indices >
+struct static_values;
+
+template< std::ptrdiff_t first, std::ptrdiff_t step, std::size_t... k >
+struct static_values< first, step, index_sequence< k... > > {
+   using type = integer_sequence<
+      std::ptrdiff_t, ( first + static_cast< std::ptrdiff_t >( k ) * step )...
+   >;
+};
+
+} // namespace detail
+
+
+
+//------------------------------------------------------------------------------
+//! @brief The values of `range( first, last, step )`, known at compile time.
+//!
+//! `for_each( fn )` calls `fn` once per value, in order, with the value as a
+//! `std::integral_constant< std::ptrdiff_t, value >`: the calls are written
+//! out one after the other, so there is no loop left to unroll, and the body
+//! can use the value as a template argument, e.g. `std::get< idx >( t )`.
+//! Meant for tiny fixed trip counts (the lanes of a vector, the rows of a 4x4
+//! matrix); each value instantiates the body once more.
+template< std::ptrdiff_t first, std::ptrdiff_t last, std::ptrdiff_t step = 1 >
+struct static_range
+{
+public:
+   using value_type = std::ptrdiff_t;
+
+   //! The values, as an integer_sequence.
+   using values = typename detail::static_values<
+      first, step, make_index_sequence< detail::static_count( first, last, step ) >
+   >::type;
+
+   static constexpr auto size() -> std::size_t {
+      return values::size();
+   }
+
+   static constexpr auto empty() -> bool {
+      return size() == 0;
+   }
+
+   template< typename Fn >
+   insist_inline RANGE_FN_CONSTEXPR14
+   static void for_each( Fn&& fn ) {
+      call_each( fn, values{} );
+   }
+
+private:
+   template< typename Fn, std::ptrdiff_t... value >
+   insist_inline RANGE_FN_CONSTEXPR14
+   static void call_each( Fn& fn, integer_sequence< std::ptrdiff_t, value... > ) {
+      // Initializer lists are evaluated in order; the leading 0 keeps the
+      // array valid for an empty range.
+      int const expand[] = {
+         0, ( static_cast< void >(
+                 fn( std::integral_constant< std::ptrdiff_t, value >{} ) ), 0 )...
+      };
+      static_cast< void >( expand );
+   }
+};
+
+
+
+
+//------------------------------------------------------------------------------
+//! @brief `num` evenly spaced values from `start` to `stop` (included if
+//! `endpoint` is true), like numpy.linspace.
+//!
+//! The values are `start + k * step`, so the last one can differ from `stop` by
+//! a rounding error.
+template< typename T >
+insist_inline RANGE_FN_CONSTEXPR14
+auto linspace( T start, T stop, std::size_t num, bool endpoint = true )
+                                                      -> detail::range< T > {
+   static_assert(
+      std::is_floating_point< T >::value,
+      "Only floating points are allowed in linspace."
+   );
+   auto const intervals = ( endpoint && num > 1 ) ? num - 1 : num;
+   auto const step = ( intervals > 0 ) ?
+                        ( stop - start ) / static_cast< T >( intervals ) : T{0};
+   return detail::range< T >{ start, step, num, detail::counted_t{} };
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief `num` values `base^x` for `x` evenly spaced from `start` to `stop`,
+//! like numpy.logspace.
+template< typename T >
+insist_inline auto logspace( T start, T stop, std::size_t num,
+                             bool endpoint = true, T base = T{10} )
+                                                -> detail::power_range< T > {
+   return detail::power_range< T >{
+      linspace( start, stop, num, endpoint ), base, T{1}
+   };
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief `num` values in geometric progression from `start` to `stop`, like
+//! numpy.geomspace.  `start` and `stop` must be non zero and of the same sign.
+template< typename T >
+insist_inline auto geomspace( T start, T stop, std::size_t num, bool endpoint = true )
+                                                -> detail::power_range< T > {
+   return detail::power_range< T >{
+      linspace( T{0}, T{1}, num, endpoint ), stop / start, start
+   };
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Every index tuple of an `N` dimensional array of extents `stops`,
+//! e.g. `range_nd( { rows, cols } )`, in row major order by default.
+template< layout order = layout::row_major, typename T, std::size_t N >
+insist_inline auto range_nd( T const (&stops)[N] ) -> detail::nd_range< T, N, order > {
+   static_assert(
+      detail::is_allowed_range_type<T>::value,
+      "Only integers, characters and floating points are allowed in ranges."
+   );
+   detail::nd_axes< T, N > axes;
+   for( std::size_t axis{0}; axis != N; ++axis ) {
+      axes.firsts[axis] = T{0};
+      axes.steps[axis] = T{1};
+      axes.counts[axis] = detail::unit_count< detail::Ascending >( T{0}, stops[axis] );
+   }
+   return detail::nd_range< T, N, order >{ axes };
+}
+
+//! Cartesian product of `range( starts[i], stops[i], steps[i] )` for each
+//! axis `i`.
+template< layout order = layout::row_major, typename T, std::size_t N >
+insist_inline auto range_nd( T const (&starts)[N], T const (&stops)[N],
+                             T const (&steps)[N] ) -> detail::nd_range< T, N, order > {
+   static_assert(
+      detail::is_allowed_range_type<T>::value,
+      "Only integers, characters and floating points are allowed in ranges."
+   );
+   detail::nd_axes< T, N > axes;
+   for( std::size_t axis{0}; axis != N; ++axis ) {
+      axes.firsts[axis] = starts[axis];
+      axes.steps[axis] = steps[axis];
+      axes.counts[axis] = detail::step_count( starts[axis], stops[axis], steps[axis] );
+   }
+   return detail::nd_range< T, N, order >{ axes };
+}
+
+
+
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//! @brief Writes values `first_k` to `last_k` (excluded) of the range starting
+//! at `first` to `out`, in loops the compiler vectorizes.
+//!
+//! The values are written in blocks of a cache line: a loop with a constant
+//! trip count is vectorized at -O2 already, where GCC does not vectorize a
+//! loop that needs a scalar epilogue.  The epilogue is bounded by the block
+//! size as well, so that the compiler does not have to prove it ends.
+template< typename T, typename Counter >
+insist_inline
+void fill_counted_values( T* out, Counter first_k, Counter last_k, T first, T step ) {
+   constexpr auto block = static_cast< Counter >( ( sizeof( T ) < 64 ) ? 64 / sizeof( T ) : 1 );
+   auto k = first_k;
+   for( ; last_k - k >= block; k += block, out += block ) {
+      for( Counter lane{0}; lane != block; ++lane ) {
+         out[lane] = nth_value( first, step, static_cast< std::ptrdiff_t >( k + lane ) );
+      }
+   }
+   for( Counter lane{0}; lane != block && k + lane != last_k; ++lane ) {
+      out[lane] = nth_value( first, step, static_cast< std::ptrdiff_t >( k + lane ) );
+   }
+}
+
+//! Values `from` to `from + size` (excluded).
+template< typename T >
+insist_inline
+auto fill_values( T* out, std::size_t from, std::size_t size, T first, T step )
+                                 -> enable_if_t< std::is_integral<T>::value > {
+   fill_counted_values( out, from, from + size, first, step );
+}
+
+//! A 32 bit counter converts to floating point in one vector instruction (a
+//! 64 bit one needs AVX-512DQ), and to the same value.
+template< typename T >
+insist_inline
+auto fill_values( T* out, std::size_t from, std::size_t size, T first, T step )
+                           -> enable_if_t< std::is_floating_point<T>::value > {
+   auto const last = from + size;
+   if( from < INT32_MAX ) {
+      auto const small_last = static_cast< std::int32_t >(
+         ( last < INT32_MAX ) ? last : INT32_MAX
+      );
+      fill_counted_values( out, static_cast< std::int32_t >( from ), small_last, first, step );
+      out += static_cast< std::size_t >( small_last ) - from;
+      from = static_cast< std::size_t >( small_last );
+   }
+   if( from != last ) {
+      fill_counted_values( out, from, last, first, step );
+   }
+}
+
+#if defined( RANGE_FN_DISPATCH_X86 )
+//! Built without contracting `first + k * step` into a fused multiply-add,
+//! which the wider instruction sets allow: floating point values would no
+//! longer be the ones iteration gives.  GCC contracts per function, clang
+//! per expression (turned off in nth_value), and has no optimize attribute.
+#  if defined( __clang__ )
+#     define RANGE_FN_TARGET( isa ) __attribute__(( target( isa ) ))
+#  else
+#     define RANGE_FN_TARGET( isa ) __attribute__(( target( isa ), optimize( "fp-contract=off" ) ))
+#  endif
+
+template< typename T >
+RANGE_FN_TARGET( "avx2" )
+void fill_values_avx2( T* out, std::size_t from, std::size_t size, T first, T step ) {
+   fill_values( out, from, size, first, step );
+}
+
+template< typename T >
+RANGE_FN_TARGET( "avx512f,avx512bw,avx512dq,avx512vl" )
+void fill_values_avx512( T* out, std::size_t from, std::size_t size, T first, T step ) {
+   fill_values( out, from, size, first, step );
+}
+
+#  undef RANGE_FN_TARGET
+#endif
+
+//------------------------------------------------------------------------------
+//! @brief fill_values, built for the widest vectors the CPU supports.
+template< typename T >
+inline void dispatch_fill_values( T* out, std::size_t from, std::size_t size,
+                                  T first, T step ) {
+#if defined( RANGE_FN_DISPATCH_X86 )
+   static bool const has_avx512 = __builtin_cpu_supports( "avx512f" )
+                                    && __builtin_cpu_supports( "avx512bw" )
+                                    && __builtin_cpu_supports( "avx512dq" )
+                                    && __builtin_cpu_supports( "avx512vl" );
+   static bool const has_avx2 = __builtin_cpu_supports( "avx2" );
+   if( has_avx512 ) { return fill_values_avx512( out, from, size, first, step ); }
+   if( has_avx2 ) { return fill_values_avx2( out, from, size, first, step ); }
+#endif
+   fill_values( out, from, size, first, step );
+}
+
+} // namespace detail
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Writes the values of `rng` to `out`, which must have room for
+//! rng.size() elements, and returns the end of the written values.
+//!
+//! The values are computed in O(1) each, so the buffer is filled with vector
+//! stores instead of one element at a time; they are the values iteration
+//! gives.
+template<
+   typename T, detail::Length length, detail::Direction direction,
+   template< typename, detail::Length, detail::Direction > class Iterator
+>
+inline auto materialize( detail::Range< T, length, direction, Iterator > const& rng,
+                         T* out ) -> T* {
+   if( !rng.empty() ) {
+      detail::dispatch_fill_values( out, 0, rng.size(), rng.front(), rng.step() );
+   }
+   return out + rng.size();
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief The values of `rng` in a vector, allocated once.
+//!
+//! A vector can only grow by values it is given, so they go through a buffer
+//! that stays in L1 cache: sizing the vector up front would write every
+//! element twice, zeros first.
+template<
+   typename T, detail::Length length, detail::Direction direction,
+   template< typename, detail::Length, detail::Direction > class Iterator
+>
+inline auto to_vector( detail::Range< T, length, direction, Iterator > const& rng )
+                                                            -> std::vector< T > {
+   constexpr std::size_t buffer_size = ( sizeof( T ) < 4096 ) ? 4096 / sizeof( T ) : 1;
+   alignas( 64 ) T buffer[buffer_size];
+   std::vector< T > values;
+   values.reserve( rng.size() );
+   for( std::size_t from{0}; from != rng.size(); ) {
+      auto const count = ( rng.size() - from < buffer_size ) ? rng.size() - from : buffer_size;
+      detail::dispatch_fill_values( buffer, from, count, rng.front(), rng.step() );
+      values.insert( values.end(), buffer, buffer + count );
+      from += count;
+   }
+   return values;
+}
+
+} // namespace estd
+
+
+
+#if defined( RANGE_FN_STD_RANGES )
+//------------------------------------------------------------------------------
+// Ranges own nothing and are cheap to copy (views), and their iterators do not
+// refer to them (borrowed ranges): std::views adaptors take them by value, and
+// std::ranges algorithms return usable iterators into temporary ranges.
+namespace std {
+namespace ranges {
+
+template<
+   typename T, estd::detail::Length length, estd::detail::Direction direction,
+   template< typename, estd::detail::Length, estd::detail::Direction > class Iterator
+>
+inline constexpr bool
+enable_view< estd::detail::Range< T, length, direction, Iterator > > = true;
+
+template<
+   typename T, estd::detail::Length length, estd::detail::Direction direction,
+   template< typename, estd::detail::Length, estd::detail::Direction > class Iterator
+>
+inline constexpr bool
+enable_borrowed_range< estd::detail::Range< T, length, direction, Iterator > > = true;
+
+template< typename T >
+inline constexpr bool enable_view< estd::detail::power_range< T > > = true;
+
+template< typename T >
+inline constexpr bool enable_borrowed_range< estd::detail::power_range< T > > = true;
+
+template< typename Sub >
+inline constexpr bool enable_view< estd::detail::chunk_range< Sub > > = true;
+
+template< typename Sub >
+inline constexpr bool enable_borrowed_range< estd::detail::chunk_range< Sub > > = true;
+
+} // namespace ranges
+} // namespace std
+#endif // RANGE_FN_STD_RANGES
 
 #endif // RANGE_FN_RANGE_HXX_
@@ -0,0 +1,211 @@
+//
+// Copyright 2018 Ghyslain Leclerc
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cstddef>
+#include <deque>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+
+#include "./catch.hpp"
+
+#include "adaptors.hxx"
+
+namespace {
+
+template< typename Range >
+auto values_of( Range const& rng ) -> std::vector< double > {
+   std::vector< double > values;
+   for( auto val : rng ) { values.push_back( static_cast< double >( val ) ); }
+   return values;
+}
+
+struct is_multiple_of_3
+{
+   bool operator()( int val ) const { return val % 3 == 0; }
+};
+
+} // namespace
+
+//==============================================================================
+SCENARIO( "Adaptors applied to ranges", "[adaptors][range]" )
+{
+   GIVEN( "ranges of various types and directions" )
+   {
+      auto const rng = estd::range( 10 );
+
+      WHEN( "elements are taken, dropped, strided or reversed" )
+      {
+         THEN( "the result is a range, with the values of the adapted one." )
+         {
+            REQUIRE( ( std::is_same< decltype( estd::take( rng, 3 ) ),
+                                     estd::detail::unit_range< int > >::value ) );
+            REQUIRE( ( std::is_same< decltype( estd::reverse( estd::up_range( 3 ) ) ),
+                                     estd::detail::down_range< int > >::value ) );
+            REQUIRE( ( values_of( estd::take( rng, 3 ) ) == std::vector< double >{ 0, 1, 2 } ) );
+            REQUIRE( estd::take( rng, 20 ).size() == 10 );
+            REQUIRE( ( values_of( estd::drop( rng, 7 ) ) == std::vector< double >{ 7, 8, 9 } ) );
+            REQUIRE( estd::drop( rng, 20 ).empty() );
+            REQUIRE( ( values_of( estd::stride( estd::range( 1, 10 ), 3 ) )
+                       == std::vector< double >{ 1, 4, 7 } ) );
+            REQUIRE( ( values_of( estd::stride( estd::down_range( 5, 0 ), 2 ) )
+                       == std::vector< double >{ 5, 3, 1 } ) );
+            REQUIRE( ( values_of( estd::reverse( estd::range( 0, 10, 3 ) ) )
+                       == std::vector< double >{ 9, 6, 3, 0 } ) );
+            REQUIRE( ( values_of( estd::reverse( estd::range( 4u ) ) )
+                       == std::vector< double >{ 3, 2, 1, 0 } ) );
+            REQUIRE( ( values_of( estd::reverse( estd::range( 0.0, 1.0, 0.25 ) ) )
+                       == std::vector< double >{ 0.75, 0.5, 0.25, 0.0 } ) );
+         }
+      }
+
+      WHEN( "the step is null or the range is empty" )
+      {
+         THEN( "a null step is taken as 1, and an empty range reversed is empty." )
+         {
+            REQUIRE( ( values_of( estd::stride( estd::range( 1, 4 ), 0 ) )
+                       == std::vector< double >{ 1, 2, 3 } ) );
+            REQUIRE( estd::stride( estd::range( 1, 1 ), 0 ).empty() );
+            REQUIRE( estd::reverse( estd::range( 5, 5 ) ).empty() );
+            REQUIRE( estd::reverse( estd::up_range( 0u ) ).empty() );
+         }
+      }
+   }
+}
+
+//==============================================================================
+SCENARIO( "Lazy composition of adaptors", "[adaptors]" )
+{
+   GIVEN( "a transformed range" )
+   {
+      auto const squares = estd::transform( estd::range( 6 ), []( int i ) { return i * i; } );
+
+      WHEN( "it is taken, strided and reversed" )
+      {
+         auto const reversed = estd::reverse( squares );
+         auto const strided = estd::stride( squares, 2 );
+         THEN( "random access and size are kept." )
+         {
+            REQUIRE( squares.size() == 6 );
+            REQUIRE( squares[4] == 16 );
+            REQUIRE( ( values_of( reversed ) == std::vector< double >{ 25, 16, 9, 4, 1, 0 } ) );
+            REQUIRE( reversed[1] == 16 );
+            REQUIRE( strided.size() == 3 );
+            REQUIRE( ( values_of( strided ) == std::vector< double >{ 0, 4, 16 } ) );
+            REQUIRE( estd::take( squares, 2 ).size() == 2 );
+         }
+      }
+   }
+
+   GIVEN( "a filtered range" )
+   {
+      auto const multiples = estd::filter( estd::range( 20 ), is_multiple_of_3{} );
+
+      WHEN( "it is taken, dropped, strided and transformed" )
+      {
+         auto const negated = estd::transform( estd::take( multiples, 3 ), []( int i ) { return -i; } );
+         THEN( "the elements are found while iterating." )
+         {
+            REQUIRE( ( values_of( multiples ) == std::vector< double >{ 0, 3, 6, 9, 12, 15, 18 } ) );
+            REQUIRE( ( values_of( estd::drop( multiples, 5 ) ) == std::vector< double >{ 15, 18 } ) );
+            REQUIRE( ( values_of( estd::stride( multiples, 3 ) ) == std::vector< double >{ 0, 9, 18 } ) );
+            REQUIRE( ( values_of( negated ) == std::vector< double >{ 0, -3, -6 } ) );
+            REQUIRE( estd::drop( multiples, 7 ).empty() );
+         }
+      }
+   }
+
+   GIVEN( "iterators taken from adaptors that no longer exist" )
+   {
+      auto make_tripled = []() {
+         return estd::transform( estd::range( 6 ), []( int i ) { return 3 * i; } );
+      };
+      auto make_odd = []() {
+         return estd::filter( estd::range( 6 ), []( int i ) { return i % 2 != 0; } );
+      };
+
+      WHEN( "they are used" )
+      {
+         auto const tripled = make_tripled().begin() + 2;
+         auto odd = make_odd().begin();
+         ++odd;
+         THEN( "they hold a copy of the function, which was trivially copyable." )
+         {
+            REQUIRE( *tripled == 6 );
+            REQUIRE( tripled[1] == 9 );
+            REQUIRE( *odd == 3 );
+         }
+      }
+   }
+
+   GIVEN( "a vector" )
+   {
+      std::vector< int > values{ 1, 2, 3, 4, 5 };
+
+      WHEN( "it is adapted" )
+      {
+         auto reversed = estd::reverse( values );
+         auto doubled = estd::transform( values, []( int i ) { return 2 * i; } );
+         values[0] = 10;
+         THEN( "it is not copied: the adaptors see its current elements." )
+         {
+            REQUIRE( ( values_of( reversed ) == std::vector< double >{ 5, 4, 3, 2, 10 } ) );
+            REQUIRE( ( values_of( doubled ) == std::vector< double >{ 20, 4, 6, 8, 10 } ) );
+            REQUIRE( ( values_of( estd::stride( values, 2 ) ) == std::vector< double >{ 10, 3, 5 } ) );
+            REQUIRE( estd::stride( values, 0 ).size() == 5 );
+         }
+      }
+   }
+}
+
+//==============================================================================
+SCENARIO( "Indices zipped with the elements of containers", "[adaptors][zip]" )
+{
+   GIVEN( "parallel arrays of various kinds" )
+   {
+      std::vector< float > out( 4 );
+      std::vector< float > const a{ 1, 2, 3, 4 };
+      float const b[4] = { 10, 20, 30, 40 };
+      std::deque< int > odd{ 1, 3, 5 };
+
+      WHEN( "they are traversed with zip and enumerate" )
+      {
+         for( auto e : estd::zip( estd::range( 4 ), out, a, b ) ) {
+            std::get< 1 >( e ) = std::get< 2 >( e ) + std::get< 3 >( e );
+         }
+         for( auto e : estd::enumerate( odd ) ) {
+            std::get< 1 >( e ) *= static_cast< int >( std::get< 0 >( e ) );
+         }
+         std::vector< int > picked;
+         for( auto e : estd::zip( estd::range( 3, -1, -2 ), a.data() ) ) {
+            picked.push_back( std::get< 0 >( e ) );
+            picked.push_back( static_cast< int >( std::get< 1 >( e ) ) );
+         }
+         auto const zipped = estd::zip( estd::range( 4 ), a );
+         THEN( "each index comes with references to the elements at that index." )
+         {
+            REQUIRE( ( out == std::vector< float >{ 11, 22, 33, 44 } ) );
+            REQUIRE( ( odd == std::deque< int >{ 0, 3, 10 } ) );
+            REQUIRE( ( picked == std::vector< int >{ 3, 4, 1, 2 } ) );
+            REQUIRE( zipped.size() == 4 );
+            REQUIRE( std::get< 1 >( zipped[2] ) == 3.0f );
+            REQUIRE( ( std::is_same< std::tuple_element< 1, decltype( zipped[0] ) >::type,
+                                     float const& >::value ) );
+         }
+      }
+   }
+}
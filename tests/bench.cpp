@@ -0,0 +1,253 @@
+//
+// Copyright 2018 Ghyslain Leclerc
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Times each range function, for each arithmetic type, against the for loop
+// one would write by hand.  Both loops store the values they visit, so neither
+// can be folded away, and the ratio shows what the range costs (1.00 is
+// free).  to_vector is compared with sizing a vector and filling it.
+//
+// Usage: range_fn_bench [--json file] [elements per case]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../range.hxx"
+
+
+namespace {
+
+struct result
+{
+   std::string name;
+   std::string type;
+   double range_ns;
+   double loop_ns;
+};
+
+template< typename T > auto type_name() -> char const*;
+template<> auto type_name< std::int8_t >() -> char const* { return "int8_t"; }
+template<> auto type_name< std::uint8_t >() -> char const* { return "uint8_t"; }
+template<> auto type_name< std::int16_t >() -> char const* { return "int16_t"; }
+template<> auto type_name< std::uint16_t >() -> char const* { return "uint16_t"; }
+template<> auto type_name< std::int32_t >() -> char const* { return "int32_t"; }
+template<> auto type_name< std::uint32_t >() -> char const* { return "uint32_t"; }
+template<> auto type_name< std::int64_t >() -> char const* { return "int64_t"; }
+template<> auto type_name< std::uint64_t >() -> char const* { return "uint64_t"; }
+template<> auto type_name< char >() -> char const* { return "char"; }
+template<> auto type_name< float >() -> char const* { return "float"; }
+template<> auto type_name< double >() -> char const* { return "double"; }
+template<> auto type_name< long double >() -> char const* { return "long double"; }
+
+// Makes the compiler assume the memory behind `ptr` is read.
+template< typename T >
+void escape( T* ptr ) {
+#if defined( __GNUC__ ) || defined( __clang__ )
+   asm volatile( "" : : "r"( ptr ) : "memory" );
+#else
+   static T* volatile sink;
+   sink = ptr;
+#endif
+}
+
+// Nanoseconds per element of a pass of `loop`, which writes `count` values to
+// `out`, over enough passes for about `elements` values.
+template< typename T, typename Loop >
+double ns_per_element( Loop& loop, T* out, std::size_t count, std::size_t elements ) {
+   auto const passes = ( elements + count - 1 ) / count;
+   auto const start = std::chrono::steady_clock::now();
+   for( auto pass : estd::range( passes ) ) {
+      (void)pass;
+      loop( out );
+      escape( out );
+   }
+   auto const time = std::chrono::duration< double, std::nano >(
+      std::chrono::steady_clock::now() - start ).count();
+   return time / static_cast< double >( passes * count );
+}
+
+// Best of 5 runs of each loop, taken in turns so that both see the same state
+// of the machine, writing to the same cache line aligned buffer.
+template< typename T, typename RangeLoop, typename RawLoop >
+void compare( std::vector< result >& results, std::size_t elements, char const* name,
+              std::size_t count, RangeLoop range_loop, RawLoop raw_loop ) {
+   std::vector< T > storage( count + 64 );
+   void* data = storage.data();
+   auto space = storage.size() * sizeof( T );
+   auto const out = static_cast< T* >( std::align( 64, count * sizeof( T ), data, space ) );
+   result res{ name, type_name< T >(), 0.0, 0.0 };
+   for( auto run : estd::range( 5 ) ) {
+      auto const range_ns = ns_per_element( range_loop, out, count, elements );
+      auto const loop_ns = ns_per_element( raw_loop, out, count, elements );
+      res.range_ns = ( run == 0 || range_ns < res.range_ns ) ? range_ns : res.range_ns;
+      res.loop_ns = ( run == 0 || loop_ns < res.loop_ns ) ? loop_ns : res.loop_ns;
+   }
+   results.push_back( res );
+}
+
+// Bounds such that `lo - 3` and `hi + 3` are still values of `T`: 120 values
+// for 8 bit types, 4096 otherwise.
+template< typename T >
+auto span() -> T {
+   return static_cast< T >( ( sizeof( T ) == 1 ) ? 120 : 4096 );
+}
+
+template< typename T >
+auto low() -> T {
+   return std::is_signed< T >::value ? static_cast< T >( -( span< T >() / 2 ) ) : T{ 3 };
+}
+
+template< typename T >
+auto high() -> T {
+   return static_cast< T >( low< T >() + span< T >() );
+}
+
+template< typename T >
+auto integral_cases( std::vector< result >& results, std::size_t elements )
+                                    -> estd::enable_if_t< std::is_integral< T >::value > {
+   T const lo = low< T >();
+   T const hi = high< T >();
+   auto const count = static_cast< std::size_t >( span< T >() );
+   auto const stepped = ( count + 2 ) / 3;
+
+   compare< T >( results, elements, "range( stop )", count,
+      [=]( T* out ) { std::size_t k{0}; for( auto v : estd::range( span< T >() ) ) { out[k++] = v; } },
+      [=]( T* out ) { std::size_t k{0}; for( T v = 0; v < span< T >(); ++v ) { out[k++] = v; } } );
+   compare< T >( results, elements, "range( start, stop ) ascending", count,
+      [=]( T* out ) { std::size_t k{0}; for( auto v : estd::range( lo, hi ) ) { out[k++] = v; } },
+      [=]( T* out ) { std::size_t k{0}; for( T v = lo; v < hi; ++v ) { out[k++] = v; } } );
+   compare< T >( results, elements, "range( start, stop ) descending", count,
+      [=]( T* out ) { std::size_t k{0}; for( auto v : estd::range( hi, lo ) ) { out[k++] = v; } },
+      [=]( T* out ) { std::size_t k{0}; for( T v = hi; v > lo; --v ) { out[k++] = v; } } );
+   compare< T >( results, elements, "range( start, stop, 3 )", stepped,
+      [=]( T* out ) { std::size_t k{0}; for( auto v : estd::range( lo, hi, 3 ) ) { out[k++] = v; } },
+      [=]( T* out ) { std::size_t k{0}; for( T v = lo; v < hi; v += 3 ) { out[k++] = v; } } );
+   compare< T >( results, elements, "range( start, stop, -3 )", stepped,
+      [=]( T* out ) { std::size_t k{0}; for( auto v : estd::range( hi, lo, -3 ) ) { out[k++] = v; } },
+      [=]( T* out ) { std::size_t k{0}; for( T v = hi; v > lo; v -= 3 ) { out[k++] = v; } } );
+   compare< T >( results, elements, "up_range( start, stop )", count,
+      [=]( T* out ) { std::size_t k{0}; for( auto v : estd::up_range( lo, hi ) ) { out[k++] = v; } },
+      [=]( T* out ) { std::size_t k{0}; for( T v = lo; v < hi; ++v ) { out[k++] = v; } } );
+   compare< T >( results, elements, "down_range( start, stop )", count,
+      [=]( T* out ) { std::size_t k{0}; for( auto v : estd::down_range( hi, lo ) ) { out[k++] = v; } },
+      [=]( T* out ) { std::size_t k{0}; for( T v = hi; v > lo; --v ) { out[k++] = v; } } );
+   compare< T >( results, elements, "to_vector( range( start, stop ) )", count,
+      [=]( T* ) { auto values = estd::to_vector( estd::range( lo, hi ) ); escape( values.data() ); },
+      [=]( T* ) {
+         std::vector< T > values( count );
+         for( std::size_t k{0}; k < count; ++k ) { values[k] = static_cast< T >( lo + k ); }
+         escape( values.data() );
+      } );
+}
+
+// Floating point ranges compute `start + k * step` from an element counter,
+// so that is the loop they are compared with.
+template< typename T >
+auto floating_cases( std::vector< result >& results, std::size_t elements )
+                              -> estd::enable_if_t< std::is_floating_point< T >::value > {
+   auto const count = std::size_t{ 4096 };
+   auto const lo = T{ -1024 };
+   auto const hi = T{ 1024 };
+   auto const step = T{ 0.5 };
+
+   compare< T >( results, elements, "range( start, stop ) ascending", count,
+      [=]( T* out ) { std::size_t k{0}; for( auto v : estd::range( T{0}, T{ 4096 } ) ) { out[k++] = v; } },
+      [=]( T* out ) { for( std::size_t k{0}; k < count; ++k ) { out[k] = static_cast< T >( k ); } } );
+   compare< T >( results, elements, "range( start, stop ) descending", count,
+      [=]( T* out ) { std::size_t k{0}; for( auto v : estd::range( T{ 4096 }, T{0} ) ) { out[k++] = v; } },
+      [=]( T* out ) { for( std::size_t k{0}; k < count; ++k ) { out[k] = T{ 4096 } - static_cast< T >( k ); } } );
+   compare< T >( results, elements, "range( start, stop, step )", count,
+      [=]( T* out ) { std::size_t k{0}; for( auto v : estd::range( lo, hi, step ) ) { out[k++] = v; } },
+      [=]( T* out ) { for( std::size_t k{0}; k < count; ++k ) { out[k] = lo + static_cast< T >( k ) * step; } } );
+   compare< T >( results, elements, "range( start, stop, -step )", count,
+      [=]( T* out ) { std::size_t k{0}; for( auto v : estd::range( hi, lo, -step ) ) { out[k++] = v; } },
+      [=]( T* out ) { for( std::size_t k{0}; k < count; ++k ) { out[k] = hi - static_cast< T >( k ) * step; } } );
+   compare< T >( results, elements, "linspace( start, stop, num )", count,
+      [=]( T* out ) { std::size_t k{0}; for( auto v : estd::linspace( lo, hi, count, false ) ) { out[k++] = v; } },
+      [=]( T* out ) { for( std::size_t k{0}; k < count; ++k ) { out[k] = lo + static_cast< T >( k ) * step; } } );
+   compare< T >( results, elements, "to_vector( range( start, stop, step ) )", count,
+      [=]( T* ) { auto values = estd::to_vector( estd::range( lo, hi, step ) ); escape( values.data() ); },
+      [=]( T* ) {
+         std::vector< T > values( count );
+         for( std::size_t k{0}; k < count; ++k ) { values[k] = lo + static_cast< T >( k ) * step; }
+         escape( values.data() );
+      } );
+}
+
+void write_json( std::FILE* file, std::vector< result > const& results, std::size_t elements ) {
+   std::fprintf( file, "{\n  \"elements\": %zu,\n  \"benchmarks\": [\n", elements );
+   for( auto idx : estd::range( results.size() ) ) {
+      auto const& res = results[idx];
+      std::fprintf( file,
+         "    { \"name\": \"%s\", \"type\": \"%s\", \"range_ns_per_element\": %.4f, "
+         "\"loop_ns_per_element\": %.4f, \"ratio\": %.3f }%s\n",
+         res.name.c_str(), res.type.c_str(), res.range_ns, res.loop_ns,
+         res.range_ns / res.loop_ns, ( idx + 1 == results.size() ) ? "" : "," );
+   }
+   std::fprintf( file, "  ]\n}\n" );
+}
+
+} // namespace
+
+
+int main( int argc, char* argv[] ) {
+   char const* json_path = nullptr;
+   std::size_t elements = 1 << 24;
+   for( auto arg : estd::range( 1, argc ) ) {
+      if( std::strcmp( argv[arg], "--json" ) == 0 && arg + 1 < argc ) {
+         json_path = argv[arg + 1];
+      } else if( arg == 1 || std::strcmp( argv[arg - 1], "--json" ) != 0 ) {
+         elements = static_cast< std::size_t >( std::atol( argv[arg] ) );
+      }
+   }
+
+   std::vector< result > results;
+   integral_cases< std::int8_t >( results, elements );
+   integral_cases< std::uint8_t >( results, elements );
+   integral_cases< std::int16_t >( results, elements );
+   integral_cases< std::uint16_t >( results, elements );
+   integral_cases< std::int32_t >( results, elements );
+   integral_cases< std::uint32_t >( results, elements );
+   integral_cases< std::int64_t >( results, elements );
+   integral_cases< std::uint64_t >( results, elements );
+   integral_cases< char >( results, elements );
+   floating_cases< float >( results, elements );
+   floating_cases< double >( results, elements );
+   floating_cases< long double >( results, elements );
+
+   std::printf( "%-40s %-12s %10s %10s %7s\n", "case", "type", "range ns", "loop ns", "ratio" );
+   for( auto const& res : results ) {
+      std::printf( "%-40s %-12s %10.3f %10.3f %7.2f\n", res.name.c_str(), res.type.c_str(),
+                   res.range_ns, res.loop_ns, res.range_ns / res.loop_ns );
+   }
+
+   if( json_path != nullptr ) {
+      auto const file = std::fopen( json_path, "w" );
+      if( file == nullptr ) {
+         std::fprintf( stderr, "cannot write %s\n", json_path );
+         return EXIT_FAILURE;
+      }
+      write_json( file, results, elements );
+      std::fclose( file );
+   }
+   return 0;
+}
@@ -1,4 +1,5 @@
 #define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_NO_POSIX_SIGNALS
 #include "./catch.hpp"
 
 // Nothing else in this file.  See catch library documentation for details.
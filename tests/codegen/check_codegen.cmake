@@ -0,0 +1,197 @@
+#
+# Copyright 2018 Ghyslain Leclerc
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+# Compiles kernels.cpp with COMPILER and FLAGS, disassembles it with OBJDUMP
+# and compares each range_<name> function with loop_<name>:
+#    - if loop_<name> has a vectorized loop, so must range_<name>;
+#    - the longest loop of range_<name> (of the vectorized ones if any) must
+#      not have more instructions than that of loop_<name>, give or take the
+#      slack listed below.
+#
+# Usage: cmake -DCOMPILER=... -DFLAGS=-O2 -DSOURCE=.../kernels.cpp
+#              -DINCLUDE_DIR=... -DOBJDUMP=... -DOBJECT=... -P check_codegen.cmake
+
+cmake_minimum_required( VERSION 3.15 )
+
+# Extra instructions per iteration that are known and accepted.  range( n ) on
+# a signed type can go down as well as up: the value moves by a step only
+# known at run time, and is one more induction variable than the index.
+set( slack_iota 1 )
+set( slack_saxpy 1 )
+set( slack_sum 1 )
+set( slack_zip_add 1 )
+
+
+separate_arguments( flags UNIX_COMMAND "${FLAGS}" )
+execute_process(
+   COMMAND "${COMPILER}" -std=c++11 ${flags} -I "${INCLUDE_DIR}"
+           -c "${SOURCE}" -o "${OBJECT}"
+   RESULT_VARIABLE status
+   ERROR_VARIABLE errors
+)
+if( NOT status EQUAL 0 )
+   message( FATAL_ERROR "Could not compile ${SOURCE}:\n${errors}" )
+endif()
+
+execute_process(
+   COMMAND "${OBJDUMP}" -d --no-show-raw-insn "${OBJECT}"
+   RESULT_VARIABLE status
+   OUTPUT_VARIABLE listing
+)
+if( NOT status EQUAL 0 )
+   message( FATAL_ERROR "Could not disassemble ${OBJECT}" )
+endif()
+
+
+# Addresses are padded to 16 digits so that they compare as strings.
+function( pad_address hex out )
+   string( LENGTH "${hex}" length )
+   math( EXPR missing "16 - ${length}" )
+   string( REPEAT "0" ${missing} zeros )
+   set( ${out} "${zeros}${hex}" PARENT_SCOPE )
+endfunction()
+
+
+# One "address|mnemonic|operands" entry per instruction, per function.
+string( REPLACE ";" " " listing "${listing}" )
+string( REPLACE "\n" ";" lines "${listing}" )
+set( functions )
+set( function )
+foreach( line IN LISTS lines )
+   if( line MATCHES "^[0-9a-f]+ <([A-Za-z0-9_]+)>:$" )
+      set( function "${CMAKE_MATCH_1}" )
+      list( APPEND functions "${function}" )
+      set( code_${function} )
+   elseif( function AND line MATCHES "^ *([0-9a-f]+):\t([a-z0-9.]+) *(.*)$" )
+      set( mnemonic "${CMAKE_MATCH_2}" )
+      set( operands "${CMAKE_MATCH_3}" )
+      pad_address( "${CMAKE_MATCH_1}" address )
+      list( APPEND code_${function} "${address}|${mnemonic}|${operands}" )
+   endif()
+endforeach()
+
+
+# Sets `address`, `mnemonic` and `operands` from an entry of code_<function>.
+macro( split_instruction instruction )
+   string( REGEX MATCH "^([^|]*)\\|([^|]*)\\|(.*)$" ignored "${instruction}" )
+   set( address "${CMAKE_MATCH_1}" )
+   set( mnemonic "${CMAKE_MATCH_2}" )
+   set( operands "${CMAKE_MATCH_3}" )
+endmacro()
+
+
+# Sets `${function}_vectorized` and `${function}_length`.  The loops are the
+# innermost backward jumps that do not cross a return.
+function( measure function )
+   set( code ${code_${function}} )
+   set( jumps )
+   foreach( instruction IN LISTS code )
+      split_instruction( "${instruction}" )
+      if( mnemonic MATCHES "^j" AND operands MATCHES "^([0-9a-f]+) <" )
+         pad_address( "${CMAKE_MATCH_1}" target )
+         if( NOT target STRGREATER address )
+            list( APPEND jumps "${target}-${address}" )
+         endif()
+      endif()
+   endforeach()
+
+   set( vectorized FALSE )
+   set( scalar_length 0 )
+   set( vector_length 0 )
+   foreach( jump IN LISTS jumps )
+      string( REPLACE "-" ";" bounds "${jump}" )
+      list( GET bounds 0 first )
+      list( GET bounds 1 last )
+      set( innermost TRUE )
+      foreach( other IN LISTS jumps )
+         string( REPLACE "-" ";" other_bounds "${other}" )
+         list( GET other_bounds 0 other_first )
+         list( GET other_bounds 1 other_last )
+         if( NOT other STREQUAL jump AND NOT other_first STRLESS first
+             AND other_last STRLESS last )
+            set( innermost FALSE )
+         endif()
+      endforeach()
+
+      set( length 0 )
+      set( returns FALSE )
+      set( vector_loop FALSE )
+      foreach( instruction IN LISTS code )
+         split_instruction( "${instruction}" )
+         if( NOT address STRLESS first AND NOT address STRGREATER last )
+            math( EXPR length "${length} + 1" )
+            if( mnemonic MATCHES "^ret" )
+               set( returns TRUE )
+            endif()
+            if( operands MATCHES "%[yz]mm" OR
+                ( operands MATCHES "%xmm" AND operands MATCHES "\\(" AND
+                  mnemonic MATCHES "^v?(p[a-z0-9]+|movdq[au][0-9]*|mov[au]p[sd]|[a-z0-9]+p[sd])$" ) )
+               set( vector_loop TRUE )
+            endif()
+         endif()
+      endforeach()
+
+      if( innermost AND NOT returns )
+         if( vector_loop )
+            set( vectorized TRUE )
+            if( length GREATER vector_length )
+               set( vector_length ${length} )
+            endif()
+         elseif( length GREATER scalar_length )
+            set( scalar_length ${length} )
+         endif()
+      endif()
+   endforeach()
+
+   set( ${function}_vectorized ${vectorized} PARENT_SCOPE )
+   if( vectorized )
+      set( ${function}_length ${vector_length} PARENT_SCOPE )
+   else()
+      set( ${function}_length ${scalar_length} PARENT_SCOPE )
+   endif()
+endfunction()
+
+
+set( failures )
+foreach( function IN LISTS functions )
+   if( NOT function MATCHES "^range_(.+)$" )
+      continue()
+   endif()
+   set( kernel "${CMAKE_MATCH_1}" )
+   measure( range_${kernel} )
+   measure( loop_${kernel} )
+   set( slack 0 )
+   if( DEFINED slack_${kernel} )
+      set( slack ${slack_${kernel}} )
+   endif()
+   math( EXPR allowed "${loop_${kernel}_length} + ${slack}" )
+
+   set( summary "${kernel}: range ${range_${kernel}_length} instructions"
+                " (vectorized: ${range_${kernel}_vectorized}), loop"
+                " ${loop_${kernel}_length} (vectorized: ${loop_${kernel}_vectorized})" )
+   string( REPLACE ";" "" summary "${summary}" )
+   message( STATUS "${summary}" )
+   if( loop_${kernel}_vectorized AND NOT range_${kernel}_vectorized )
+      list( APPEND failures "${kernel} is not vectorized with a range" )
+   elseif( range_${kernel}_length GREATER allowed )
+      list( APPEND failures "${kernel} has a longer loop with a range" )
+   endif()
+endforeach()
+
+if( failures )
+   string( REPLACE ";" "\n   " failures "${failures}" )
+   message( FATAL_ERROR "Abstraction penalty with ${COMPILER} ${FLAGS}:\n   ${failures}" )
+endif()
@@ -0,0 +1,125 @@
+//
+// Copyright 2018 Ghyslain Leclerc
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Kernels checked by check_codegen.cmake.  Each range_<name> must compile to
+// loops no longer than those of loop_<name>, the same kernel written with a
+// plain for loop, and must be vectorized whenever loop_<name> is.
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+#include "adaptors.hxx"
+
+
+extern "C" {
+
+void range_iota( int* out, int n ) {
+   for( auto idx : estd::range( n ) ) { out[idx] = idx; }
+}
+
+void loop_iota( int* out, int n ) {
+   for( int idx = 0; idx < n; ++idx ) { out[idx] = idx; }
+}
+
+
+void range_saxpy( float* y, float const* x, float a, int n ) {
+   for( auto idx : estd::range( n ) ) { y[idx] += a * x[idx]; }
+}
+
+void loop_saxpy( float* y, float const* x, float a, int n ) {
+   for( int idx = 0; idx < n; ++idx ) { y[idx] += a * x[idx]; }
+}
+
+
+void range_up_saxpy( float* y, float const* x, float a, std::size_t n ) {
+   for( auto idx : estd::up_range( n ) ) { y[idx] += a * x[idx]; }
+}
+
+void loop_up_saxpy( float* y, float const* x, float a, std::size_t n ) {
+   for( std::size_t idx = 0; idx < n; ++idx ) { y[idx] += a * x[idx]; }
+}
+
+
+void range_reverse_copy( int* out, int const* in, int n ) {
+   for( auto idx : estd::range( n - 1, -1 ) ) { out[n - 1 - idx] = in[idx]; }
+}
+
+void loop_reverse_copy( int* out, int const* in, int n ) {
+   for( int idx = n - 1; idx > -1; --idx ) { out[n - 1 - idx] = in[idx]; }
+}
+
+
+void range_even_scale( double* y, double const* x, int n ) {
+   for( auto idx : estd::range( 0, n, 2 ) ) { y[idx] = 2.0 * x[idx]; }
+}
+
+void loop_even_scale( double* y, double const* x, int n ) {
+   for( int idx = 0; idx < n; idx += 2 ) { y[idx] = 2.0 * x[idx]; }
+}
+
+
+auto range_sum( std::int32_t const* x, int n ) -> std::int32_t {
+   std::int32_t total{0};
+   for( auto idx : estd::range( n ) ) { total += x[idx]; }
+   return total;
+}
+
+auto loop_sum( std::int32_t const* x, int n ) -> std::int32_t {
+   std::int32_t total{0};
+   for( int idx = 0; idx < n; ++idx ) { total += x[idx]; }
+   return total;
+}
+
+
+void range_zip_add( float* out, float const* a, float const* b, int n ) {
+   for( auto e : estd::zip( estd::range( n ), out, a, b ) ) {
+      std::get< 1 >( e ) = std::get< 2 >( e ) + std::get< 3 >( e );
+   }
+}
+
+void loop_zip_add( float* out, float const* a, float const* b, int n ) {
+   for( int idx = 0; idx < n; ++idx ) { out[idx] = a[idx] + b[idx]; }
+}
+
+
+void range_enumerate_ramp( std::vector< float >& values ) {
+   for( auto e : estd::enumerate( values ) ) {
+      std::get< 1 >( e ) += static_cast< float >( std::get< 0 >( e ) );
+   }
+}
+
+void loop_enumerate_ramp( std::vector< float >& values ) {
+   auto const data = values.data();
+   for( std::size_t idx = 0; idx < values.size(); ++idx ) {
+      data[idx] += static_cast< float >( idx );
+   }
+}
+
+
+void range_samples( float* out, float first, float step, std::size_t n ) {
+   std::size_t k{0};
+   for( auto val : estd::range( first, first + static_cast< float >( n ) * step, step ) ) {
+      out[k++] = val;
+   }
+}
+
+void loop_samples( float* out, float first, float step, std::size_t n ) {
+   for( std::size_t k = 0; k < n; ++k ) { out[k] = first + static_cast< float >( k ) * step; }
+}
+
+}
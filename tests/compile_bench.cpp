@@ -0,0 +1,151 @@
+//
+// Copyright 2018 Ghyslain Leclerc
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures what including range.hxx costs the translation units of its users.
+// compile_bench_tu.cpp (all range functions, all allowed types) is compiled as
+// many times as there are translation units asked for, with the compiler the
+// project is configured with, and the time spent in the front end (parsing
+// and template instantiation, -fsyntax-only) is reported.  One more
+// compilation counts the templates of estd instantiated: classes and
+// functions with GCC (-fdump-lang-class, -fdump-tree-original), the
+// instantiation events of -ftime-trace with clang.
+//
+// Usage: range_fn_compile_bench [translation units] [standard, e.g. c++17]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "../range.hxx"
+
+
+namespace {
+
+std::string const compiler = RANGE_FN_CXX;
+std::string const compiler_id = RANGE_FN_CXX_ID;
+std::string const source = RANGE_FN_COMPILE_BENCH_TU;
+std::string const include_dir = RANGE_FN_INCLUDE_DIR;
+std::string const work_dir = RANGE_FN_WORK_DIR;
+
+auto quoted( std::string const& text ) -> std::string {
+   return "\"" + text + "\"";
+}
+
+// Runs the compiler on the benchmark translation unit with `options`, returns
+// the seconds it took or a negative value if it failed.
+auto compile( std::string const& standard, std::string const& options ) -> double {
+   auto const command = quoted( compiler ) + " -std=" + standard + " -I " + quoted( include_dir )
+                      + " " + options + " " + quoted( source );
+   auto const start = std::chrono::steady_clock::now();
+   auto const status = std::system( command.c_str() );
+   auto const time = std::chrono::duration< double >(
+      std::chrono::steady_clock::now() - start ).count();
+   return ( status == 0 ) ? time : -1.0;
+}
+
+auto read_file( std::string const& path ) -> std::string {
+   std::ifstream file( path );
+   return std::string( std::istreambuf_iterator< char >( file ),
+                       std::istreambuf_iterator< char >() );
+}
+
+// Number of lines of `text` that start with `prefix` and mention estd.
+auto count_lines( std::string const& text, std::string const& prefix ) -> std::size_t {
+   std::size_t count{0};
+   std::size_t line{0};
+   while( line < text.size() ) {
+      auto eol = text.find( '\n', line );
+      eol = ( eol == std::string::npos ) ? text.size() : eol;
+      if( text.compare( line, prefix.size(), prefix ) == 0
+          && text.find( "estd::", line ) < eol ) {
+         ++count;
+      }
+      line = eol + 1;
+   }
+   return count;
+}
+
+// Number of -ftime-trace events named `name` whose detail mentions estd.
+auto count_events( std::string const& trace, std::string const& name ) -> std::size_t {
+   auto const key = "\"name\":\"" + name + "\"";
+   std::size_t count{0};
+   for( auto pos = trace.find( key ); pos != std::string::npos; pos = trace.find( key, pos + 1 ) ) {
+      auto const event_end = trace.find( '}', pos );
+      auto const detail = trace.find( "estd::", pos );
+      if( detail < event_end ) {
+         ++count;
+      }
+   }
+   return count;
+}
+
+// Prints the number of class and function templates of estd instantiated, as
+// far as the compiler can tell.
+auto count_instantiations( std::string const& standard ) -> bool {
+   auto const object = work_dir + "/compile_bench_tu.o";
+   if( compiler_id == "GNU" ) {
+      auto const classes = work_dir + "/compile_bench_tu.class";
+      auto const functions = work_dir + "/compile_bench_tu.original";
+      if( compile( standard, "-c -o " + quoted( object ) + " -fdump-lang-class="
+                             + quoted( classes ) + " -fdump-tree-original="
+                             + quoted( functions ) ) < 0.0 ) {
+         return false;
+      }
+      std::printf( "instantiated: %zu classes, %zu functions of estd\n",
+                   count_lines( read_file( classes ), "Class estd::" ),
+                   count_lines( read_file( functions ), ";; Function " ) );
+   } else if( compiler_id.find( "Clang" ) != std::string::npos ) {
+      if( compile( standard, "-c -o " + quoted( object ) + " -ftime-trace" ) < 0.0 ) {
+         return false;
+      }
+      auto const trace = read_file( work_dir + "/compile_bench_tu.json" );
+      std::printf( "instantiated: %zu classes, %zu functions of estd\n",
+                   count_events( trace, "InstantiateClass" ),
+                   count_events( trace, "InstantiateFunction" ) );
+   }
+   return true;
+}
+
+} // namespace
+
+
+int main( int argc, char* argv[] ) {
+   auto const units = ( argc > 1 ) ? std::atoi( argv[1] ) : 16;
+   std::string const standard = ( argc > 2 ) ? argv[2] : "c++11";
+
+   double total{0.0};
+   for( auto unit : estd::range( units ) ) {
+      (void)unit;
+      auto const time = compile( standard, "-fsyntax-only" );
+      if( time < 0.0 ) {
+         std::fprintf( stderr, "cannot compile %s\n", source.c_str() );
+         return EXIT_FAILURE;
+      }
+      total += time;
+   }
+   std::printf( "%s -std=%s, %d translation units\n", compiler.c_str(), standard.c_str(), units );
+   std::printf( "front end: %.3f s, %.3f s per translation unit\n",
+                total, total / static_cast< double >( units ) );
+
+   if( !count_instantiations( standard ) ) {
+      std::fprintf( stderr, "cannot count the instantiations\n" );
+      return EXIT_FAILURE;
+   }
+   return 0;
+}
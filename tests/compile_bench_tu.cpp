@@ -0,0 +1,63 @@
+//
+// Copyright 2018 Ghyslain Leclerc
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// The translation unit compiled by range_fn_compile_bench: every range
+// function, for every allowed type, with the iterator operations a typical
+// user of the header ends up instantiating.
+
+#include "range.hxx"
+
+
+namespace {
+
+template< typename Range >
+auto use( Range rng ) -> long double {
+   long double total{0};
+   for( auto val : rng ) { total += static_cast< long double >( val ); }
+   auto first = rng.begin();
+   auto last = rng.end();
+   if( first != last && first < last ) {
+      total += static_cast< long double >( first[1] );
+      total += static_cast< long double >( *( --last ) );
+      total += static_cast< long double >( last - first );
+      first += 2;
+      total += static_cast< long double >( *( first++ ) );
+   }
+   total += static_cast< long double >( rng.size() );
+   return total;
+}
+
+template< typename T >
+auto use_all() -> long double {
+   return use( estd::range( T{10} ) )
+        + use( estd::range( T{1}, T{10} ) )
+        + use( estd::range( T{1}, T{10}, 2 ) )
+        + use( estd::up_range( T{1}, T{10} ) )
+        + use( estd::down_range( T{10}, T{1} ) );
+}
+
+} // namespace
+
+
+auto compile_bench_tu() -> long double {
+   return use_all< char >() + use_all< char16_t >() + use_all< char32_t >()
+        + use_all< wchar_t >() + use_all< signed char >() + use_all< unsigned char >()
+        + use_all< short >() + use_all< unsigned short >() + use_all< int >()
+        + use_all< unsigned >() + use_all< long >() + use_all< unsigned long >()
+        + use_all< long long >() + use_all< unsigned long long >()
+        + use_all< float >() + use_all< double >() + use_all< long double >()
+        + use( estd::linspace( 0.0, 1.0, 11 ) ) + use( estd::linspace( 0.0f, 1.0f, 11 ) );
+}
@@ -0,0 +1,168 @@
+//
+// Copyright 2018 Ghyslain Leclerc
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+
+#include "./catch.hpp"
+
+#include "curve.hxx"
+
+namespace {
+
+// Hilbert curve position to (x, y), as given on Wikipedia.
+std::array<int, 2> hilbert_point( int side, int pos ) {
+   int x = 0;
+   int y = 0;
+   for( int s = 1; s < side; s *= 2 ) {
+      int const rx = 1 & ( pos / 2 );
+      int const ry = 1 & ( pos ^ rx );
+      if( ry == 0 ) {
+         if( rx == 1 ) {
+            x = s - 1 - x;
+            y = s - 1 - y;
+         }
+         int const tmp = x;
+         x = y;
+         y = tmp;
+      }
+      x += s * rx;
+      y += s * ry;
+      pos /= 4;
+   }
+   return { { x, y } };
+}
+
+template< typename Range >
+std::vector< std::array<int, 2> > points_of( Range const& rng ) {
+   std::vector< std::array<int, 2> > points;
+   for( auto point : rng ) { points.push_back( point ); }
+   return points;
+}
+
+} // namespace
+
+//==============================================================================
+SCENARIO( "Space filling curve orders over a 2D range", "[curve]" )
+{
+   GIVEN( "a square whose side is a power of two" )
+   {
+      WHEN( "it is iterated in Morton and Hilbert order" )
+      {
+         auto morton = points_of( estd::morton_range( { 4, 4 } ) );
+         auto hilbert = points_of( estd::hilbert_range( { 16, 16 } ) );
+         std::vector< std::array<int, 2> > expected_hilbert;
+         for( auto pos : estd::range( 256 ) ) { expected_hilbert.push_back( hilbert_point( 16, pos ) ); }
+         bool neighbours = true;
+         for( std::size_t idx{1}; idx != hilbert.size(); ++idx ) {
+            neighbours = neighbours && std::abs( hilbert[idx][0] - hilbert[idx - 1][0] )
+                                        + std::abs( hilbert[idx][1] - hilbert[idx - 1][1] ) == 1;
+         }
+         THEN( "the points follow the curves." )
+         {
+            REQUIRE( morton.size() == 16 );
+            REQUIRE( ( morton[2] == std::array<int, 2>{ { 1, 0 } } ) );
+            REQUIRE( ( morton[5] == std::array<int, 2>{ { 0, 3 } } ) );
+            REQUIRE( ( morton[8] == std::array<int, 2>{ { 2, 0 } } ) );
+            REQUIRE( ( morton[15] == std::array<int, 2>{ { 3, 3 } } ) );
+            REQUIRE( hilbert == expected_hilbert );
+            REQUIRE( neighbours );
+         }
+      }
+   }
+
+   GIVEN( "a space that is neither square nor a power of two" )
+   {
+      auto morton = estd::morton_range( { 5, 11 } );
+      auto hilbert = estd::hilbert_range( { 13, 3 } );
+
+      WHEN( "it is iterated" )
+      {
+         std::vector<int> morton_visits( 55, 0 );
+         for( auto point : morton ) { ++morton_visits[ point[0] * 11 + point[1] ]; }
+         std::vector<int> hilbert_visits( 39, 0 );
+         for( auto point : hilbert ) { ++hilbert_visits[ point[0] * 3 + point[1] ]; }
+         THEN( "every point is visited exactly once." )
+         {
+            REQUIRE( morton.size() == 55 );
+            REQUIRE( morton_visits == std::vector<int>( 55, 1 ) );
+            REQUIRE( hilbert.size() == 39 );
+            REQUIRE( hilbert_visits == std::vector<int>( 39, 1 ) );
+         }
+      }
+
+      WHEN( "its points are accessed at random or sliced" )
+      {
+         auto morton_points = points_of( morton );
+         auto hilbert_points = points_of( hilbert );
+         bool same = true;
+         for( auto idx : estd::range( morton.size() ) ) {
+            same = same && morton[idx] == morton_points[idx];
+         }
+         for( auto idx : estd::range( hilbert.size() ) ) {
+            same = same && hilbert[idx] == hilbert_points[idx];
+         }
+         auto iter = hilbert.end();
+         --iter;
+         THEN( "the points are those at the same positions along the curve." )
+         {
+            REQUIRE( same );
+            REQUIRE( ( *iter == hilbert_points.back() ) );
+            REQUIRE( ( *( hilbert.begin() + 20 ) == hilbert_points[20] ) );
+            REQUIRE( ( points_of( morton.slice( 17, 40 ) )
+                       == std::vector< std::array<int, 2> >( morton_points.begin() + 17,
+                                                             morton_points.begin() + 40 ) ) );
+            REQUIRE( hilbert.split().first.size() == 20 );
+            REQUIRE( ( hilbert.split().second.front() == hilbert_points[20] ) );
+         }
+      }
+   }
+
+   GIVEN( "ranges with starts and steps, and empty ranges" )
+   {
+      auto rng = estd::hilbert_range( { 10, 0 }, { 0, 4 }, { -5, 2 } );
+      THEN( "the values are those of the axes, along the curve." )
+      {
+         REQUIRE( ( points_of( rng ) == std::vector< std::array<int, 2> >{
+                       { { 10, 0 } }, { { 10, 2 } }, { { 5, 2 } }, { { 5, 0 } } } ) );
+         REQUIRE( estd::morton_range( { 0, 7 } ).empty() );
+         REQUIRE( estd::morton_range( { 0, 7 } ).begin() == estd::morton_range( { 0, 7 } ).end() );
+         REQUIRE( estd::hilbert_range( { 1, 1 } ).size() == 1 );
+      }
+   }
+
+   GIVEN( "spaces at and past the largest side of a curve, 2^32 points" )
+   {
+      std::int64_t const largest = std::int64_t{1} << 32;
+      THEN( "the largest side is covered, and a longer one is rejected." )
+      {
+         auto const morton = estd::morton_range( { std::int64_t{1}, largest } );
+         auto const hilbert = estd::hilbert_range( { largest, std::int64_t{1} } );
+         REQUIRE( morton.size() == static_cast< std::size_t >( largest ) );
+         REQUIRE( ( morton.back() == std::array< std::int64_t, 2 >{ { 0, largest - 1 } } ) );
+         REQUIRE( ( morton[12345] == std::array< std::int64_t, 2 >{ { 0, 12345 } } ) );
+         REQUIRE( ( *hilbert.begin() == std::array< std::int64_t, 2 >{ { 0, 0 } } ) );
+         REQUIRE( hilbert.split().second.size() == static_cast< std::size_t >( largest / 2 ) );
+         REQUIRE_THROWS_AS( estd::morton_range( { std::int64_t{1}, largest + 1 } ), std::length_error );
+         REQUIRE_THROWS_AS( estd::hilbert_range( { largest + 1, std::int64_t{1} } ), std::length_error );
+      }
+   }
+}
@@ -0,0 +1,117 @@
+//
+// Copyright 2018 Ghyslain Leclerc
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Compares the schedules of estd::parallel_for on loop
+// bodies whose cost varies with the index, then times the uniform one on
+// pools of 1, 2, 4... threads up to `num_threads` for the speedup.
+//
+// Usage: range_fn_parallel_bench [num_threads]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "../parallel.hxx"
+
+
+namespace {
+
+// Roughly `cost` units of work that the optimizer cannot remove.
+void spin( long cost ) {
+   volatile double sink = 1.0;
+   for( auto iter : estd::range( cost ) ) {
+      sink = std::sqrt( sink + static_cast< double >( iter ) );
+   }
+}
+
+struct workload
+{
+   char const* name;
+   long (*cost)( int idx, int size );
+};
+
+long uniform( int, int ) { return 50; }
+
+// The first 1% of the indices cost 1000 times the others.
+long front_loaded( int idx, int size ) { return ( idx < size / 100 ) ? 10000 : 10; }
+
+// Cost grows linearly with the index, like a triangular loop nest.
+long triangular( int idx, int size ) { return 1 + ( 200L * idx ) / size; }
+
+// One index in 512 costs 1000 times the others, scattered.
+long spikes( int idx, int ) { return ( ( idx * 2654435761u ) % 512 == 0 ) ? 10000 : 10; }
+
+template< typename Function >
+double seconds( Function&& fn ) {
+   auto const start = std::chrono::steady_clock::now();
+   fn();
+   return std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+}
+
+} // namespace
+
+
+int main( int argc, char* argv[] ) {
+   auto const num_threads = ( argc > 1 ) ?
+      static_cast< std::size_t >( std::atol( argv[1] ) ) :
+      estd::thread_pool::default_size();
+   estd::thread_pool pool{ num_threads };
+   int const size = 200000;
+
+   workload const workloads[] = {
+      { "uniform", &uniform },
+      { "front_loaded", &front_loaded },
+      { "triangular", &triangular },
+      { "spikes", &spikes }
+   };
+
+   std::printf( "%zu threads, %d indices\n", pool.size(), size );
+   std::printf( "%-14s %12s %12s %12s %12s %12s\n", "workload", "serial (s)",
+                "chunked (s)", "stealing (s)", "dynamic (s)", "guided (s)" );
+   for( auto const& load : workloads ) {
+      auto body = [&]( int idx ) { spin( load.cost( idx, size ) ); };
+      auto const serial = seconds( [&] {
+         for( auto idx : estd::range( size ) ) { body( idx ); }
+      } );
+      auto const chunked = seconds( [&] {
+         estd::parallel_for( pool, estd::range( size ), body, 0, estd::schedule::chunked );
+      } );
+      auto const stealing = seconds( [&] {
+         estd::parallel_for( pool, estd::range( size ), body, 0, estd::schedule::stealing );
+      } );
+      auto const dynamic = seconds( [&] {
+         estd::parallel_for( pool, estd::range( size ), body, 0, estd::schedule::dynamic );
+      } );
+      auto const guided = seconds( [&] {
+         estd::parallel_for( pool, estd::range( size ), body, 0, estd::schedule::guided );
+      } );
+      std::printf( "%-14s %12.4f %12.4f %12.4f %12.4f %12.4f\n",
+                   load.name, serial, chunked, stealing, dynamic, guided );
+   }
+
+   std::printf( "\n%-14s %12s %12s\n", "threads", "uniform (s)", "speedup" );
+   auto single = 0.0;
+   for( std::size_t threads{1}; threads <= num_threads; threads *= 2 ) {
+      estd::thread_pool sized{ threads };
+      auto const time = seconds( [&] {
+         estd::parallel_for( sized, estd::range( size ), [&]( int idx ) { spin( uniform( idx, size ) ); } );
+      } );
+      single = ( threads == 1 ) ? time : single;
+      std::printf( "%-14zu %12.4f %12.2f\n", threads, time, single / time );
+   }
+   return 0;
+}
@@ -0,0 +1,348 @@
+//
+// Copyright 2018 Ghyslain Leclerc
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+
+#include "./catch.hpp"
+
+#include "parallel.hxx"
+
+//==============================================================================
+SCENARIO( "Parallel loop over a range", "[parallel][parallel_for]" )
+{
+   GIVEN( "a thread pool and a range with a step" )
+   {
+      estd::thread_pool pool{ 4 };
+      auto rng = estd::range( 3, 10000, 7 );
+
+      WHEN( "parallel_for is called with a small grain" )
+      {
+         std::vector< std::atomic<int> > visits( 10000 );
+         for( auto& visit : visits ) { visit = 0; }
+         estd::parallel_for( pool, rng, [&]( int idx ) { ++visits[idx]; }, 10 );
+         THEN( "every value of the range is visited exactly once." )
+         {
+            bool exactly_once = true;
+            for( auto idx : estd::range( 10000 ) ) {
+               auto const expected = ( idx >= 3 && ( idx - 3 ) % 7 == 0 ) ? 1 : 0;
+               exactly_once = exactly_once && ( visits[idx] == expected );
+            }
+            REQUIRE( exactly_once );
+         }
+      }
+
+      WHEN( "parallel_for is called on the range cut in chunks" )
+      {
+         std::vector< std::atomic<int> > visits( 10000 );
+         for( auto& visit : visits ) { visit = 0; }
+         std::atomic<int> num_calls{0};
+         estd::parallel_for( pool, rng.chunks( 256 ), [&]( decltype( rng ) chunk ) {
+            ++num_calls;
+            for( auto idx : chunk ) { ++visits[idx]; }
+         } );
+         THEN( "the body is called once per chunk and every value is visited once." )
+         {
+            bool exactly_once = true;
+            for( auto idx : estd::range( 10000 ) ) {
+               auto const expected = ( idx >= 3 && ( idx - 3 ) % 7 == 0 ) ? 1 : 0;
+               exactly_once = exactly_once && ( visits[idx] == expected );
+            }
+            REQUIRE( exactly_once );
+            REQUIRE( num_calls == static_cast< int >( rng.chunks( 256 ).size() ) );
+         }
+      }
+
+      WHEN( "parallel_for is called on a descending range with the default grain" )
+      {
+         std::atomic<long> sum{0};
+         estd::parallel_for( pool, estd::range( 1000, 0 ), [&]( int idx ) { sum += idx; } );
+         THEN( "every value of the range is visited." )
+         {
+            REQUIRE( sum == 500500 );
+         }
+      }
+
+      WHEN( "the loop body throws" )
+      {
+         THEN( "the exception is propagated to the caller." )
+         {
+            REQUIRE_THROWS_AS(
+               estd::parallel_for(
+                  pool, rng,
+                  []( int idx ) { if( idx == 703 ) { throw std::runtime_error{ "" }; } },
+                  16
+               ),
+               std::runtime_error
+            );
+         }
+      }
+
+      WHEN( "parallel_for is called from inside a parallel_for" )
+      {
+         std::atomic<int> count{0};
+         estd::parallel_for( pool, estd::range( 8 ), [&]( int ) {
+            estd::parallel_for( pool, estd::range( 100 ), [&]( int ) { ++count; } );
+         }, 1 );
+         THEN( "the inner loops run on the calling worker." )
+         {
+            REQUIRE( count == 800 );
+         }
+      }
+   }
+
+   GIVEN( "a thread pool and a loop body whose cost depends on the index" )
+   {
+      estd::thread_pool pool{ 3 };
+      auto body = []( std::atomic<long>& sum, int idx ) {
+         auto val = 0;
+         for( auto iter : estd::range( ( idx % 97 == 0 ) ? 20000 : 1 ) ) { val += iter & 1; }
+         sum += idx + ( val & 0 );
+      };
+
+      WHEN( "parallel_for is called with each schedule" )
+      {
+         std::atomic<long> stolen_sum{0};
+         estd::parallel_for(
+            pool, estd::range( 0, 20000, 2 ),
+            [&]( int idx ) { body( stolen_sum, idx ); }, 1, estd::schedule::stealing
+         );
+         std::atomic<long> chunked_sum{0};
+         estd::parallel_for(
+            pool, estd::range( 0, 20000, 2 ),
+            [&]( int idx ) { body( chunked_sum, idx ); }, 0, estd::schedule::chunked
+         );
+         std::atomic<long> dynamic_sum{0};
+         estd::parallel_for(
+            pool, estd::range( 0, 20000, 2 ),
+            [&]( int idx ) { body( dynamic_sum, idx ); }, 3, estd::schedule::dynamic
+         );
+         std::atomic<long> guided_sum{0};
+         estd::parallel_for(
+            pool, estd::range( 0, 20000, 2 ),
+            [&]( int idx ) { body( guided_sum, idx ); }, 0, estd::schedule::guided
+         );
+         THEN( "every value of the range is visited exactly once." )
+         {
+            REQUIRE( stolen_sum == 99990000 );
+            REQUIRE( chunked_sum == 99990000 );
+            REQUIRE( dynamic_sum == 99990000 );
+            REQUIRE( guided_sum == 99990000 );
+         }
+      }
+
+      WHEN( "the loop body throws while work is being stolen" )
+      {
+         THEN( "the exception is propagated to the caller." )
+         {
+            REQUIRE_THROWS_AS(
+               estd::parallel_for(
+                  pool, estd::range( 5000 ),
+                  []( int idx ) { if( idx == 4321 ) { throw std::runtime_error{ "" }; } },
+                  4
+               ),
+               std::runtime_error
+            );
+         }
+      }
+   }
+
+   GIVEN( "a thread pool and a two dimensional range" )
+   {
+      estd::thread_pool pool{ 3 };
+      std::vector< std::atomic<int> > visits( 50 * 80 );
+      for( auto& visit : visits ) { visit = 0; }
+
+      WHEN( "parallel_for is called on the whole iteration space" )
+      {
+         estd::parallel_for(
+            pool, estd::range_nd( { 50, 80 } ),
+            [&]( std::array<int, 2> idx ) { ++visits[ idx[0] * 80 + idx[1] ]; }, 7
+         );
+         THEN( "every tuple is visited exactly once." )
+         {
+            bool exactly_once = true;
+            for( auto& visit : visits ) { exactly_once = exactly_once && ( visit == 1 ); }
+            REQUIRE( exactly_once );
+         }
+      }
+   }
+
+   GIVEN( "the default pool and an empty range" )
+   {
+      int calls = 0;
+      estd::parallel_for( estd::range( 0 ), [&]( int ) { ++calls; } );
+      THEN( "the body is never called." )
+      {
+         REQUIRE( calls == 0 );
+         REQUIRE( estd::default_pool().size() >= 1 );
+      }
+   }
+}
+
+
+
+//==============================================================================
+SCENARIO( "Shared range handing out chunks", "[parallel][shared_range]" )
+{
+   GIVEN( "a range shared between threads in fixed size chunks" )
+   {
+      auto rng = estd::range( 5, 100005, 3 );
+      estd::shared_range< decltype( rng ) > shared{ rng, 7 };
+
+      WHEN( "several threads take chunks until it is exhausted" )
+      {
+         std::vector< std::atomic<int> > visits( 100005 );
+         for( auto& visit : visits ) { visit = 0; }
+         auto worker = [&]() {
+            auto chunk = rng.slice( 0, 0 );
+            while( shared.next( chunk ) ) {
+               for( auto val : chunk ) { ++visits[val]; }
+            }
+         };
+         std::vector< std::thread > threads;
+         for( auto thread : estd::range( 4 ) ) { (void)thread; threads.emplace_back( worker ); }
+         for( auto& thread : threads ) { thread.join(); }
+
+         THEN( "every value is visited exactly once and the range stays exhausted." )
+         {
+            bool exactly_once = true;
+            for( auto idx : estd::range( 100005 ) ) {
+               auto const expected = ( idx >= 5 && ( idx - 5 ) % 3 == 0 ) ? 1 : 0;
+               exactly_once = exactly_once && ( visits[idx] == expected );
+            }
+            REQUIRE( exactly_once );
+            std::size_t first{0};
+            std::size_t last{0};
+            REQUIRE_FALSE( shared.next( first, last ) );
+         }
+      }
+   }
+
+   GIVEN( "a range shared in guided chunks" )
+   {
+      std::size_t const size = 10007;
+      std::size_t const min_chunk = 5;
+      auto rng = estd::range( size );
+      estd::shared_range< decltype( rng ) > shared{ rng, min_chunk, 4 };
+
+      WHEN( "the chunks are taken one after the other" )
+      {
+         std::vector< std::size_t > sizes;
+         std::size_t expected_first{0};
+         bool contiguous = true;
+         std::size_t first{0};
+         std::size_t last{0};
+         while( shared.next( first, last ) ) {
+            contiguous = contiguous && ( first == expected_first );
+            expected_first = last;
+            sizes.push_back( last - first );
+         }
+
+         THEN( "they cover the range and shrink down to the minimum size." )
+         {
+            REQUIRE( contiguous );
+            REQUIRE( expected_first == size );
+            REQUIRE( sizes.front() == size / 4 );
+            REQUIRE( std::is_sorted( sizes.rbegin(), sizes.rend() ) );
+            bool large_enough = true;
+            for( auto idx : estd::range( sizes.size() - 1 ) ) {
+               large_enough = large_enough && ( sizes[idx] >= min_chunk );
+            }
+            REQUIRE( large_enough );
+         }
+      }
+   }
+}
+
+
+
+//==============================================================================
+SCENARIO( "Parallel reductions over a range", "[parallel][reduce]" )
+{
+   GIVEN( "a thread pool and an integral range" )
+   {
+      estd::thread_pool pool{ 4 };
+      auto rng = estd::range( -1000, 100001, 3 );
+      long long expected{0};
+      for( auto val : rng ) { expected += val; }
+
+      WHEN( "it is reduced with the default operation" )
+      {
+         auto const sum = estd::reduce( pool, rng, 0LL );
+         auto const fixed_sum = estd::reduce( pool, rng, 0LL, std::plus< long long >{}, 100,
+                                              estd::reduction_order::fixed );
+         THEN( "the result is the sum of its values." )
+         {
+            REQUIRE( sum == expected );
+            REQUIRE( fixed_sum == expected );
+         }
+      }
+
+      WHEN( "it is reduced with another operation and a transformation" )
+      {
+         auto const max_square = estd::transform_reduce(
+            pool, rng, 0LL,
+            []( long long lhs, long long rhs ) { return std::max( lhs, rhs ); },
+            []( int val ) { return static_cast< long long >( val ) * val; }, 7
+         );
+         THEN( "the result is the largest transformed value." )
+         {
+            REQUIRE( max_square == 99998LL * 99998LL );
+         }
+      }
+
+      WHEN( "the range is empty or smaller than the accumulators" )
+      {
+         THEN( "the initial value is combined with the values." )
+         {
+            REQUIRE( estd::reduce( pool, estd::range( 5, 5 ), 42 ) == 42 );
+            REQUIRE( estd::reduce( pool, estd::range( 5, 8 ), 42 ) == 60 );
+            REQUIRE( estd::reduce( estd::range( 1, 20 ), 1LL, std::multiplies< long long >{},
+                                   0, estd::reduction_order::fixed ) == 121645100408832000LL );
+         }
+      }
+   }
+
+   GIVEN( "floating point values summed in a fixed order" )
+   {
+      auto rng = estd::range( 0.0, 1000.0, 0.001 );
+      auto fn = []( double val ) { return std::sin( val ) * 1e8 + 1.0 / ( val + 1.0 ); };
+
+      WHEN( "the sum is computed with pools of different sizes" )
+      {
+         std::vector< double > sums;
+         for( std::size_t num_threads : { 1, 2, 3, 5 } ) {
+            estd::thread_pool pool{ num_threads };
+            sums.push_back( estd::transform_reduce( pool, rng, 0.0, std::plus< double >{}, fn,
+                                                    0, estd::reduction_order::fixed ) );
+         }
+         THEN( "the results are identical, bit for bit." )
+         {
+            REQUIRE( sums[0] == sums[1] );
+            REQUIRE( sums[0] == sums[2] );
+            REQUIRE( sums[0] == sums[3] );
+         }
+      }
+   }
+}
@@ -14,7 +14,14 @@
 // limitations under the License.
 //
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
 
@@ -38,13 +45,13 @@ SCENARIO( "Python like range function", "[range][iteration]" )
          }
       }
 
-      WHEN( "it is used in a range based for loop with the auto& variable" )
+      WHEN( "it is used in a range based for loop with the auto&& variable" )
       {
-         for( auto& i : estd::range( 1 ) )
+         for( auto&& i : estd::range( 1 ) )
          {
-            THEN( "the type of the auto variable is int&." )
+            THEN( "the type of the auto variable is int&&: values are returned by value." )
             {
-               REQUIRE( std::is_same< decltype( i ), int& >::value );
+               REQUIRE( std::is_same< decltype( i ), int&& >::value );
             }
          }
       }
@@ -94,13 +101,13 @@ SCENARIO( "Python like range function", "[range][iteration]" )
 
    GIVEN( "a 'range of double' object obtained using the estd::range function" )
    {
-      WHEN( "it is used in a range based for loop with the auto& variable" )
+      WHEN( "it is used in a range based for loop with the auto&& variable" )
       {
-         for( auto& i : estd::range( 1.0 ) )
+         for( auto&& i : estd::range( 1.0 ) )
          {
-            THEN( "the type of the auto variable is double&." )
+            THEN( "the type of the auto variable is double&&." )
             {
-               REQUIRE( std::is_same< decltype( i ), double& >::value );
+               REQUIRE( std::is_same< decltype( i ), double&& >::value );
             }
          }
       }
@@ -114,7 +121,7 @@ SCENARIO( "Python like range function", "[range][iteration]" )
       the_vec.reserve( n );
       WHEN( "range is called with that number to loop and fill the empty vector" )
       {
-         for( auto& cur_idx : estd::range( n ) )
+         for( auto&& cur_idx : estd::range( n ) )
          {
             the_vec.push_back( cur_idx );
          }
@@ -244,4 +251,916 @@ SCENARIO( "Python like range function", "[range][iteration]" )
          }
       }
    }
+
+
+   GIVEN( "a pair of ascending integral numbers [b, e[ and a step s that does not divide e - b" )
+   {
+      int b = 4;
+      int e = 32;
+      int s = 5;
+      std::vector<int> the_vec;
+      WHEN( "range is called with those numbers" )
+      {
+         for( auto const& cur_idx : estd::range( b, e, s ) )
+         {
+            the_vec.push_back( cur_idx );
+         }
+         THEN( "the resulting vector stops at the last number below e." )
+         {
+            REQUIRE( the_vec == std::vector<int>{ 4, 9, 14, 19, 24, 29 } );
+         }
+      }
+   }
+
+
+   GIVEN( "a pair of descending unsigned numbers [b, e[ and a negative step s" )
+   {
+      unsigned int b = 9u;
+      unsigned int e = 0u;
+      int s = -2;
+      std::vector<unsigned int> the_vec;
+      WHEN( "range is called with those numbers" )
+      {
+         for( auto const& cur_idx : estd::range( b, e, s ) )
+         {
+            the_vec.push_back( cur_idx );
+         }
+         THEN( "the resulting vector counts down without wrapping around." )
+         {
+            REQUIRE( the_vec == std::vector<unsigned int>{ 9u, 7u, 5u, 3u, 1u } );
+         }
+      }
+   }
+
+
+   GIVEN( "a step s going away from the end of the range" )
+   {
+      std::vector<int> the_vec;
+      WHEN( "range is called with that step" )
+      {
+         for( auto const& cur_idx : estd::range( 0, 10, -1 ) )
+         {
+            the_vec.push_back( cur_idx );
+         }
+         for( auto const& cur_idx : estd::range( 10, 0, 0 ) )
+         {
+            the_vec.push_back( cur_idx );
+         }
+         THEN( "the range is empty." )
+         {
+            REQUIRE( the_vec.empty() );
+         }
+      }
+   }
+
+
+   GIVEN( "a pair of integral numbers [b, e[ near the limits of the type" )
+   {
+      std::int8_t b = 100;
+      std::int8_t e = 127;
+      std::vector<std::int8_t> the_vec;
+      WHEN( "range is called with a step that overshoots the limit" )
+      {
+         for( auto const& cur_idx : estd::range( b, e, 20 ) )
+         {
+            the_vec.push_back( cur_idx );
+         }
+         THEN( "the iteration stops after the last number below e." )
+         {
+            REQUIRE( the_vec == std::vector<std::int8_t>{ 100, 120 } );
+         }
+      }
+
+      WHEN( "an int range steps right below the largest int" )
+      {
+         std::vector<int> values;
+         for( auto cur_idx : estd::range( 0, std::numeric_limits<int>::max(), 1 << 30 ) ) {
+            values.push_back( cur_idx );
+         }
+         THEN( "moving past the last value does not overflow (checked by UBSan)." )
+         {
+            REQUIRE( values == std::vector<int>{ 0, 1 << 30 } );
+         }
+      }
+   }
+}
+
+
+//==============================================================================
+SCENARIO( "Random access iteration through a range", "[range][iterator]" )
+{
+   GIVEN( "a range with a step s that does not divide e - b" )
+   {
+      auto rng = estd::range( 3, 1000, 7 );
+      auto b = rng.begin();
+      auto e = rng.end();
+
+      WHEN( "the distance between its begin and end iterators is computed" )
+      {
+         auto dist = std::distance( b, e );
+         THEN( "it is the number of elements in the range." )
+         {
+            REQUIRE( dist == 143 );
+            REQUIRE( ( e - b ) == 143 );
+         }
+      }
+
+      WHEN( "the begin iterator is moved forward and back" )
+      {
+         std::advance( b, 100 );
+         THEN( "it points to the element with the corresponding index." )
+         {
+            REQUIRE( *b == 3 + 100 * 7 );
+            REQUIRE( b[-100] == 3 );
+            REQUIRE( *( b - 1 ) == 3 + 99 * 7 );
+            REQUIRE( *( 2 + b ) == 3 + 102 * 7 );
+            REQUIRE( *--e == 3 + 142 * 7 );
+            REQUIRE( b < e );
+            REQUIRE( e >= b );
+         }
+      }
+
+      WHEN( "its iterator category is looked up and the range is walked backwards" )
+      {
+         using category = std::iterator_traits< decltype( b ) >::iterator_category;
+         using reverse = std::reverse_iterator< decltype( b ) >;
+         std::vector< int > backwards;
+         for( auto it = reverse( e ); reverse( b ) - it > 0; it += 50 ) {
+            backwards.push_back( *it );
+         }
+         THEN( "it is random access, and std::reverse_iterator reads the values." )
+         {
+            REQUIRE( ( std::is_same< category, std::random_access_iterator_tag >::value ) );
+            REQUIRE( ( std::is_same< decltype( *b ), int >::value ) );
+            REQUIRE( ( backwards == std::vector< int >{ 997, 647, 297 } ) );
+         }
+      }
+
+      WHEN( "a value is searched for with std::lower_bound" )
+      {
+         auto found = std::lower_bound( b, e, 500 );
+         THEN( "the first element not less than the value is found." )
+         {
+            REQUIRE( *found == 500 );
+            REQUIRE( ( found - b ) == 71 );
+         }
+      }
+   }
+
+   GIVEN( "a descending unit range" )
+   {
+      auto rng = estd::range( 10, 0 );
+      WHEN( "its iterator is indexed" )
+      {
+         auto b = rng.begin();
+         THEN( "values go down from the start." )
+         {
+            REQUIRE( b[0] == 10 );
+            REQUIRE( b[9] == 1 );
+            REQUIRE( std::distance( b, rng.end() ) == 10 );
+         }
+      }
+   }
+}
+
+
+
+//==============================================================================
+SCENARIO( "Size and element access of a range", "[range][access]" )
+{
+   GIVEN( "an ascending range with a step that does not divide its length" )
+   {
+      auto rng = estd::range( 4, 32, 5 );
+      THEN( "its size, first and last elements are known without iterating." )
+      {
+         REQUIRE( rng.size() == 6 );
+         REQUIRE_FALSE( rng.empty() );
+         REQUIRE( rng.front() == 4 );
+         REQUIRE( rng.back() == 29 );
+         REQUIRE( rng[3] == 19 );
+      }
+   }
+
+   GIVEN( "a descending unit range" )
+   {
+      auto rng = estd::range( 13, 7 );
+      THEN( "its size, first and last elements are known without iterating." )
+      {
+         REQUIRE( rng.size() == 6 );
+         REQUIRE( rng.front() == 13 );
+         REQUIRE( rng.back() == 8 );
+         REQUIRE( rng[2] == 11 );
+      }
+   }
+
+   GIVEN( "a descending floating point range with a step" )
+   {
+      auto rng = estd::range( 13.4f, -15.18f, -3.0f );
+      THEN( "its size matches the number of iterations." )
+      {
+         std::size_t count{0};
+         for( auto cur_idx : rng ) { (void)cur_idx; ++count; }
+         REQUIRE( rng.size() == count );
+         REQUIRE( rng.size() == 10 );
+         REQUIRE( rng.back() == Approx( -13.6f ) );
+      }
+   }
+
+   GIVEN( "a descending range with an odd number of elements" )
+   {
+      auto rng = estd::range( 20, 5, -3 );
+      WHEN( "it is split in halves or in proportions" )
+      {
+         auto halves = rng.split();
+         auto parts = rng.split( 1, 3 );
+         auto unweighted = rng.split( 0, 0 );
+         auto slice = rng.slice( 1, 3 );
+         THEN( "the parts are ranges of the same type covering it in order." )
+         {
+            REQUIRE( rng.size() == 5 );
+            REQUIRE( halves.first.size() == 3 );
+            REQUIRE( halves.second.size() == 2 );
+            REQUIRE( halves.second.front() == 11 );
+            REQUIRE( halves.second.back() == 8 );
+            REQUIRE( parts.first.size() == 1 );
+            REQUIRE( parts.second.front() == 17 );
+            REQUIRE( unweighted.first.size() == 5 );
+            REQUIRE( unweighted.second.empty() );
+            REQUIRE( slice.front() == 17 );
+            REQUIRE( slice.back() == 14 );
+            REQUIRE( std::is_same< decltype( slice ), decltype( rng ) >::value );
+         }
+      }
+   }
+
+   GIVEN( "ranges with equal bounds or a step going away from the end" )
+   {
+      THEN( "they are empty." )
+      {
+         REQUIRE( estd::range( 5, 5 ).empty() );
+         REQUIRE( estd::range( 0u ).size() == 0 );
+         REQUIRE( estd::range( 0, 10, -2 ).empty() );
+      }
+   }
+}
+
+
+
+//==============================================================================
+SCENARIO( "Ranges with a direction known at compile time", "[range][direction]" )
+{
+   GIVEN( "a pair of ascending integral numbers [b, e[" )
+   {
+      int b = 15;
+      int e = 20;
+      WHEN( "up_range and down_range are called with those numbers" )
+      {
+         std::vector<int> up_vec;
+         for( auto cur_idx : estd::up_range( b, e ) ) { up_vec.push_back( cur_idx ); }
+         std::vector<int> down_vec;
+         for( auto cur_idx : estd::down_range( e, b ) ) { down_vec.push_back( cur_idx ); }
+         THEN( "they iterate in their own direction." )
+         {
+            REQUIRE( up_vec == std::vector<int>{ 15, 16, 17, 18, 19 } );
+            REQUIRE( down_vec == std::vector<int>{ 20, 19, 18, 17, 16 } );
+            REQUIRE( estd::down_range( e, b ).back() == 16 );
+         }
+      }
+
+      WHEN( "up_range and down_range are called with the bounds swapped" )
+      {
+         THEN( "the ranges are empty." )
+         {
+            REQUIRE( estd::up_range( e, b ).empty() );
+            REQUIRE( estd::down_range( b, e ).empty() );
+            REQUIRE( estd::up_range( -3 ).empty() );
+         }
+      }
+   }
+
+   GIVEN( "a range of unsigned int obtained with only a stop value" )
+   {
+      auto rng = estd::range( 4u );
+      THEN( "it is a range that can only go up." )
+      {
+         REQUIRE( std::is_same< decltype( rng ), estd::detail::up_range< unsigned int > >::value );
+         REQUIRE( rng.size() == 4 );
+         REQUIRE( rng.back() == 3u );
+      }
+   }
+
+   GIVEN( "an ascending range of floating point numbers" )
+   {
+      std::vector<double> the_vec;
+      for( auto&& cur_idx : estd::up_range( 0.5, 3.0 ) ) { the_vec.push_back( cur_idx ); }
+      THEN( "it yields the same values as the equivalent range." )
+      {
+         REQUIRE( the_vec == std::vector<double>{ 0.5, 1.5, 2.5 } );
+      }
+   }
+}
+
+
+
+//==============================================================================
+SCENARIO( "Floating point ranges do not accumulate rounding errors", "[range][floating]" )
+{
+   GIVEN( "a floating point range with a step that is not exactly representable" )
+   {
+      double b = 0.0;
+      double e = 1000.0;
+      double s = 0.1;
+      auto rng = estd::range( b, e, s );
+
+      THEN( "its number of elements is the rounded up ratio of length to step." )
+      {
+         REQUIRE( rng.size() == 10000 );
+      }
+
+      WHEN( "it is iterated" )
+      {
+         std::size_t count{0};
+         bool all_exact = true;
+         for( auto cur_val : rng ) {
+            all_exact = all_exact
+                        && ( cur_val == b + static_cast<double>( count ) * s );
+            ++count;
+         }
+         THEN( "every value is start + k * step and the count is the size." )
+         {
+            REQUIRE( all_exact );
+            REQUIRE( count == rng.size() );
+            REQUIRE( *( rng.begin() + 5000 ) == rng[5000] );
+            REQUIRE( *( --rng.end() ) == rng.back() );
+         }
+      }
+   }
+}
+
+
+
+//==============================================================================
+SCENARIO( "Evenly spaced samples between two values", "[range][linspace]" )
+{
+   GIVEN( "two floating point values and a number of samples" )
+   {
+      double b = 0.0;
+      double e = 1.0;
+      std::size_t n = 5;
+
+      WHEN( "linspace is called with those values" )
+      {
+         std::vector<double> with_end;
+         for( auto cur_val : estd::linspace( b, e, n ) ) { with_end.push_back( cur_val ); }
+         std::vector<double> without_end;
+         for( auto cur_val : estd::linspace( b, e, n, false ) ) { without_end.push_back( cur_val ); }
+         THEN( "the samples are evenly spaced, with or without the end value." )
+         {
+            REQUIRE( with_end == std::vector<double>{ 0.0, 0.25, 0.5, 0.75, 1.0 } );
+            REQUIRE( without_end.size() == n );
+            REQUIRE( without_end[3] == Approx( 0.6 ) );
+            REQUIRE( without_end[4] == Approx( 0.8 ) );
+            REQUIRE( estd::linspace( b, e, n ).size() == n );
+            REQUIRE( estd::linspace( b, e, 0 ).empty() );
+            REQUIRE( estd::linspace( b, e, 1 ).back() == b );
+         }
+      }
+
+      WHEN( "logspace and geomspace are called with matching values" )
+      {
+         auto logs = estd::logspace( 0.0, 3.0, 4 );
+         auto geoms = estd::geomspace( 1.0, 1000.0, 4 );
+         auto halves = estd::geomspace( 1.0, 0.0625, 4, false );
+         THEN( "the samples are in geometric progression." )
+         {
+            REQUIRE( logs.size() == 4 );
+            REQUIRE( geoms.size() == 4 );
+            REQUIRE( logs[0] == 1.0 );
+            REQUIRE( logs.back() == Approx( 1000.0 ) );
+            REQUIRE( *( logs.begin() + 2 ) == Approx( 100.0 ) );
+            REQUIRE( std::distance( geoms.begin(), geoms.end() ) == 4 );
+            REQUIRE( geoms.front() == 1.0 );
+            REQUIRE( geoms[1] == Approx( 10.0 ) );
+            REQUIRE( geoms.back() == Approx( 1000.0 ) );
+            REQUIRE( halves[3] == Approx( 0.125 ) );
+            REQUIRE( estd::logspace( 0.0, 4.0, 5, true, 2.0 )[4] == Approx( 16.0 ) );
+         }
+      }
+   }
+}
+
+
+
+//==============================================================================
+SCENARIO( "Iterating over a range in batches", "[range][batched]" )
+{
+   GIVEN( "a range whose size is not a multiple of the batch width" )
+   {
+      auto rng = estd::range( 10, -11, -2 );
+
+      WHEN( "it is iterated in batches of 4" )
+      {
+         std::vector<int> values;
+         std::vector<std::size_t> counts;
+         bool aligned = true;
+         for( auto const& b : rng.batched<4>() ) {
+            aligned = aligned
+                        && reinterpret_cast< std::uintptr_t >( b.data() ) % 16 == 0;
+            counts.push_back( b.count );
+            for( std::size_t lane{0}; lane != b.size(); ++lane ) { values.push_back( b[lane] ); }
+         }
+         THEN( "the batches hold consecutive values and the last lanes repeat the last one." )
+         {
+            REQUIRE( rng.batched<4>().size() == 3 );
+            REQUIRE( counts == std::vector<std::size_t>{ 4, 4, 3 } );
+            REQUIRE( values == std::vector<int>{ 10, 8, 6, 4, 2, 0, -2, -4, -6, -8, -10, -10 } );
+            REQUIRE( aligned );
+         }
+      }
+   }
+
+   GIVEN( "a floating point range and an empty range" )
+   {
+      auto rng = estd::range( 0.0, 1000.0, 0.1 );
+
+      WHEN( "they are iterated in batches of 8" )
+      {
+         bool exact = true;
+         std::size_t num_values{0};
+         for( auto const& b : rng.batched<8>() ) {
+            for( std::size_t lane{0}; lane != b.count; ++lane ) {
+               exact = exact && ( b[lane] == rng[num_values] );
+               ++num_values;
+            }
+         }
+         std::size_t num_empty{0};
+         for( auto const& b : estd::range( 5, 5 ).batched<8>() ) { num_empty += b.count; }
+         THEN( "every value is the one of the range at the same position." )
+         {
+            REQUIRE( exact );
+            REQUIRE( num_values == rng.size() );
+            REQUIRE( num_empty == 0 );
+            REQUIRE( estd::range( 5, 5 ).batched<8>().empty() );
+            REQUIRE( ( *estd::up_range( 3u, 11u ).batched<8>().begin() ).full() );
+         }
+      }
+   }
+}
+
+
+
+//==============================================================================
+SCENARIO( "Iterating over a range in chunks and windows", "[range][chunks]" )
+{
+   GIVEN( "a range whose size is not a multiple of the chunk size" )
+   {
+      auto rng = estd::range( 10, -11, -2 );
+
+      WHEN( "it is cut in chunks of 4" )
+      {
+         auto const chunks = rng.chunks( 4 );
+         std::vector<int> values;
+         std::vector<std::size_t> sizes;
+         for( auto chunk : chunks ) {
+            sizes.push_back( chunk.size() );
+            for( auto val : chunk ) { values.push_back( val ); }
+         }
+         THEN( "the chunks are ranges of the same type, covering it in order." )
+         {
+            REQUIRE( ( std::is_same< decltype( chunks[0] ), decltype( rng ) >::value ) );
+            REQUIRE( chunks.size() == 3 );
+            REQUIRE( sizes == std::vector<std::size_t>{ 4, 4, 3 } );
+            REQUIRE( values == std::vector<int>{ 10, 8, 6, 4, 2, 0, -2, -4, -6, -8, -10 } );
+            REQUIRE( chunks[1].front() == 2 );
+            REQUIRE( chunks.back().back() == -10 );
+            REQUIRE( ( chunks.end() - chunks.begin() ) == 3 );
+            REQUIRE( ( *( chunks.begin() + 2 ) ).size() == 3 );
+            REQUIRE( estd::range( 0 ).chunks( 4 ).empty() );
+         }
+      }
+
+      WHEN( "it is cut in chunks of 0" )
+      {
+         auto const chunks = rng.chunks( 0 );
+         THEN( "the chunks hold one value each, as for chunks of 1." )
+         {
+            REQUIRE( chunks.size() == rng.size() );
+            REQUIRE( chunks[0].size() == 1 );
+            REQUIRE( chunks.back().front() == -10 );
+         }
+      }
+
+      WHEN( "the chunks are sliced and split" )
+      {
+         auto const last_two = rng.chunks( 4 ).slice( 1, 3 );
+         auto const halves = rng.chunks( 3 ).split();
+         THEN( "the parts hold the same chunks as the whole." )
+         {
+            REQUIRE( last_two.size() == 2 );
+            REQUIRE( last_two[0].front() == 2 );
+            REQUIRE( last_two[1].size() == 3 );
+            REQUIRE( halves.first.size() == 2 );
+            REQUIRE( halves.second.size() == 2 );
+            REQUIRE( halves.second[0].front() == -2 );
+            REQUIRE( halves.second[1].size() == 2 );
+            REQUIRE( rng.chunks( 4 ).slice( 3, 3 ).empty() );
+         }
+      }
+   }
+
+   GIVEN( "a floating point range" )
+   {
+      auto rng = estd::range( 0.0, 1.0, 0.25 );
+
+      WHEN( "windows of 3 values slide over it" )
+      {
+         std::vector<double> sums;
+         for( auto window : rng.slide( 3 ) ) {
+            double sum{0.0};
+            for( auto val : window ) { sum += val; }
+            sums.push_back( sum );
+         }
+         THEN( "there is a window starting at each value that has 2 values after it." )
+         {
+            REQUIRE( rng.slide( 3 ).size() == 2 );
+            REQUIRE( sums == std::vector<double>{ 0.75, 1.5 } );
+            REQUIRE( rng.slide( 3 ).slice( 1, 2 )[0].front() == 0.25 );
+            REQUIRE( rng.slide( 4 ).size() == 1 );
+            REQUIRE( rng.slide( 5 ).empty() );
+         }
+      }
+   }
 }
+
+
+
+//==============================================================================
+SCENARIO( "Writing the values of a range to memory", "[range][materialize]" )
+{
+   GIVEN( "ranges of every size of integers and of floating points" )
+   {
+      auto as_iterated = []( decltype( estd::range( 0.0, 1.0, 0.1 ) ) rng ) {
+         std::vector<double> values;
+         for( auto val : rng ) { values.push_back( val ); }
+         return values;
+      };
+
+      WHEN( "they are converted to vectors" )
+      {
+         auto int8s = estd::to_vector( estd::range( std::int8_t{127}, std::int8_t{-128}, -3 ) );
+         auto int64s = estd::to_vector( estd::range( std::int64_t{-5}, std::int64_t{1000}, 7 ) );
+         auto uint16s = estd::to_vector( estd::down_range( std::uint16_t{70}, std::uint16_t{0} ) );
+         auto floats = estd::to_vector( estd::range( 1.5f, 0.0f, -0.001f ) );
+         auto doubles = estd::to_vector( estd::range( 0.0, 100.0, 0.01 ) );
+         THEN( "the vectors hold the values of the ranges, in order." )
+         {
+            REQUIRE( int8s.size() == 85 );
+            REQUIRE( int8s.front() == 127 );
+            REQUIRE( int8s.back() == -125 );
+            REQUIRE( int8s[3] == 118 );
+            REQUIRE( int64s.size() == 144 );
+            REQUIRE( int64s[143] == 996 );
+            REQUIRE( uint16s.size() == 70 );
+            REQUIRE( uint16s.back() == 1 );
+            bool exact = floats.size() == estd::range( 1.5f, 0.0f, -0.001f ).size();
+            for( std::size_t idx{0}; exact && idx != floats.size(); ++idx ) {
+               exact = floats[idx] == estd::range( 1.5f, 0.0f, -0.001f )[idx];
+            }
+            REQUIRE( exact );
+            REQUIRE( doubles == as_iterated( estd::range( 0.0, 100.0, 0.01 ) ) );
+            REQUIRE( estd::to_vector( estd::range( 3, 3 ) ).empty() );
+         }
+      }
+
+      WHEN( "a range is written to a raw buffer" )
+      {
+         int buffer[8] = { 0, 0, 0, 0, 0, 0, 0, -1 };
+         auto const end = estd::materialize( estd::range( 10, 3 ), buffer );
+         THEN( "the values are written and the end of the written values is returned." )
+         {
+            REQUIRE( end == buffer + 7 );
+            REQUIRE( buffer[0] == 10 );
+            REQUIRE( buffer[6] == 4 );
+            REQUIRE( buffer[7] == -1 );
+         }
+      }
+   }
+}
+
+
+
+//==============================================================================
+SCENARIO( "Multi-dimensional ranges", "[range][range_nd]" )
+{
+   GIVEN( "the extents of a three dimensional array" )
+   {
+      auto rng = estd::range_nd( { 2, 3, 4 } );
+
+      WHEN( "the range is iterated" )
+      {
+         std::vector< std::array<int, 3> > tuples;
+         for( auto idx : rng ) { tuples.push_back( idx ); }
+         std::vector< std::array<int, 3> > nested;
+         for( auto i : estd::range( 2 ) ) {
+            for( auto j : estd::range( 3 ) ) {
+               for( auto k : estd::range( 4 ) ) { nested.push_back( { { i, j, k } } ); }
+            }
+         }
+         THEN( "the tuples are those of nested loops, last axis fastest." )
+         {
+            REQUIRE( rng.size() == 24 );
+            REQUIRE( tuples == nested );
+            REQUIRE( ( rng.extents() == std::array<std::size_t, 3>{ { 2, 3, 4 } } ) );
+         }
+      }
+
+      WHEN( "its tuples are accessed at random" )
+      {
+         auto iter = rng.begin() + 17;
+         auto back = rng.end();
+         --back;
+         THEN( "they are computed from their position." )
+         {
+            REQUIRE( ( *iter == std::array<int, 3>{ { 1, 1, 1 } } ) );
+            REQUIRE( ( rng[5] == std::array<int, 3>{ { 0, 1, 1 } } ) );
+            REQUIRE( ( *back == rng.back() ) );
+            REQUIRE( ( *( iter - 6 ) == rng[11] ) );
+            REQUIRE( ( *( --iter ) == rng[16] ) );
+            REQUIRE( rng.end() - rng.begin() == 24 );
+            REQUIRE( std::distance( rng.slice( 5, 19 ).begin(), rng.slice( 5, 19 ).end() ) == 14 );
+            REQUIRE( ( rng.slice( 5, 19 ).front() == rng[5] ) );
+         }
+      }
+   }
+
+   GIVEN( "per axis starts, stops and steps in column major order" )
+   {
+      auto rng = estd::range_nd< estd::layout::column_major >(
+         { 0.0, 10.0 }, { 1.0, 0.0 }, { 0.25, -5.0 }
+      );
+
+      WHEN( "the range is iterated" )
+      {
+         std::vector< std::array<double, 2> > tuples( rng.begin(), rng.end() );
+         THEN( "the first axis varies fastest." )
+         {
+            REQUIRE( tuples.size() == 8 );
+            REQUIRE( ( tuples[1] == std::array<double, 2>{ { 0.25, 10.0 } } ) );
+            REQUIRE( ( tuples[4] == std::array<double, 2>{ { 0.0, 5.0 } } ) );
+            REQUIRE( ( tuples.back() == std::array<double, 2>{ { 0.75, 5.0 } } ) );
+            REQUIRE( estd::range_nd( { 3, 0, 2 } ).empty() );
+            REQUIRE( estd::range_nd( { 3, 0, 2 } ).begin() == estd::range_nd( { 3, 0, 2 } ).end() );
+         }
+      }
+   }
+}
+
+
+
+//==============================================================================
+namespace {
+
+struct append_value
+{
+   std::vector< std::ptrdiff_t >* values;
+
+   template< typename Index >
+   void operator()( Index idx ) const {
+      values->push_back( idx );
+   }
+};
+
+struct add_element
+{
+   std::tuple< int, long, double > const* elements;
+   double* total;
+
+   template< typename Index >
+   void operator()( Index ) const {
+      *total += static_cast< double >( std::get< Index::value >( *elements ) );
+   }
+};
+
+} // namespace
+
+static_assert( std::is_same< estd::make_index_sequence< 5 >,
+                             estd::index_sequence< 0, 1, 2, 3, 4 > >::value,
+               "make_index_sequence counts from 0" );
+static_assert( std::is_same< estd::static_range< 7, -3, -4 >::values,
+                             estd::integer_sequence< std::ptrdiff_t, 7, 3, -1 > >::value,
+               "static_range has the values of range( first, last, step )" );
+
+SCENARIO( "Loops unrolled at compile time", "[range][static_range]" )
+{
+   GIVEN( "static ranges with various bounds and steps" )
+   {
+      WHEN( "a callable is invoked for each value" )
+      {
+         std::vector< std::ptrdiff_t > up, down, empty;
+         estd::static_range< 0, 8 >::for_each( append_value{ &up } );
+         estd::static_range< 10, 0, -3 >::for_each( append_value{ &down } );
+         estd::static_range< 5, 5 >::for_each( append_value{ &empty } );
+         THEN( "it sees the values of the runtime range, in order." )
+         {
+            REQUIRE( ( up == std::vector< std::ptrdiff_t >( estd::range( 0, 8 ).begin(),
+                                                           estd::range( 0, 8 ).end() ) ) );
+            REQUIRE( ( down == std::vector< std::ptrdiff_t >{ 10, 7, 4, 1 } ) );
+            REQUIRE( empty.empty() );
+            REQUIRE( estd::static_range< 10, 0, -3 >::size() == 4 );
+            REQUIRE( estd::static_range< 0, 8, 0 >::empty() );
+         }
+      }
+
+      WHEN( "the values are used as template arguments" )
+      {
+         auto const elements = std::make_tuple( 1, 20L, 0.5 );
+         double total{0};
+         estd::static_range< 0, 3 >::for_each( add_element{ &elements, &total } );
+         THEN( "each element of a tuple can be reached." )
+         {
+            REQUIRE( total == 21.5 );
+         }
+      }
+   }
+}
+
+
+
+//==============================================================================
+SCENARIO( "Unrolled loops over a range", "[range][unrolled]" )
+{
+   GIVEN( "ranges whose sizes are and are not multiples of the unroll factor" )
+   {
+      auto const values_of = []( estd::detail::range< double > rng ) {
+         return std::vector< double >( rng.begin(), rng.end() );
+      };
+
+      WHEN( "the loops are unrolled" )
+      {
+         std::vector< double > by_4, by_3, by_8;
+         auto rng = estd::range( 0.5, 4.0, 0.25 );
+         rng.unrolled< 4 >( [&]( double val ) { by_4.push_back( val ); } );
+         rng.unrolled< 3 >( [&]( double val ) { by_3.push_back( val ); } );
+         estd::range( 0.0, 1.0, 0.5 ).unrolled< 8 >( [&]( double val ) { by_8.push_back( val ); } );
+         THEN( "every value is visited once, in order, as by a for loop." )
+         {
+            REQUIRE( rng.size() == 14 );
+            REQUIRE( by_4 == values_of( rng ) );
+            REQUIRE( by_3 == values_of( rng ) );
+            REQUIRE( ( by_8 == std::vector< double >{ 0.0, 0.5 } ) );
+         }
+      }
+
+      WHEN( "an integral range going down is unrolled" )
+      {
+         std::vector< int > values;
+         estd::range( 10, 0 ).unrolled< 4 >( [&]( int val ) { values.push_back( val ); } );
+         THEN( "the values are those of the range." )
+         {
+            REQUIRE( ( values == std::vector< int >{ 10, 9, 8, 7, 6, 5, 4, 3, 2, 1 } ) );
+         }
+      }
+   }
+}
+
+
+
+//==============================================================================
+// Checked by the compiler: a failure here breaks the build of the tests.
+static_assert( estd::range( 10 ).size() == 10, "range( stop ) is constexpr" );
+static_assert( estd::range( 2, 7 )[3] == 5, "range( start, stop ) is constexpr" );
+static_assert( estd::range( 5, -5 ).back() == -4, "descending ranges are constexpr" );
+static_assert( estd::down_range( 5, 0 ).front() == 5, "down_range is constexpr" );
+static_assert( estd::range( 0.0, 2.5 ).size() == 3, "floating ranges are constexpr" );
+
+#if defined( __cpp_constexpr ) && __cpp_constexpr >= 201304L
+
+namespace {
+
+template< typename Range >
+constexpr auto sum_of( Range rng ) -> double {
+   double total{0};
+   for( auto val : rng ) { total += val; }
+   return total;
+}
+
+struct squares_table
+{
+   std::uint32_t values[16];
+};
+
+constexpr auto make_squares() -> squares_table {
+   squares_table table{};
+   for( auto idx : estd::range( 16u ) ) { table.values[idx] = idx * idx; }
+   return table;
+}
+
+constexpr auto squares = make_squares();
+
+static_assert( squares.values[15] == 225, "tables can be built at compile time" );
+static_assert( sum_of( estd::range( 10, 0, -3 ) ) == 22, "iteration is constexpr" );
+static_assert( estd::range( 0, 10, 3 ).size() == 4, "range( start, stop, step ) is constexpr" );
+static_assert( estd::range( 3 ).begin()[1] == 1 && *estd::range( 3 ).begin() == 0,
+               "dereferencing is constexpr" );
+static_assert( !std::is_assignable< decltype( *std::declval< estd::detail::range_iterator<
+                  int, estd::detail::Unit, estd::detail::Runtime > const& >() ), int >::value,
+               "a const iterator can not change the values of its range" );
+#if !defined( RANGE_FN_USE_FMA ) // std::fma is only constexpr from C++23
+static_assert( sum_of( estd::range( 0.0, 1.0, 0.25 ) ) == 1.5, "floating iteration is constexpr" );
+static_assert( estd::linspace( 0.0, 1.0, 5 )[2] == 0.5, "linspace is constexpr" );
+#endif
+
+} // namespace
+
+SCENARIO( "Ranges in constant expressions", "[range][constexpr]" )
+{
+   GIVEN( "a table of squares built at compile time" )
+   {
+      WHEN( "it is compared with the same table built at run time" )
+      {
+         std::vector< std::uint32_t > expected;
+         for( auto idx : estd::range( 16u ) ) { expected.push_back( idx * idx ); }
+         THEN( "both have the same values." )
+         {
+            REQUIRE( std::equal( expected.begin(), expected.end(), squares.values ) );
+         }
+      }
+   }
+}
+
+#endif
+
+
+
+//==============================================================================
+#if defined( RANGE_FN_STD_RANGES )
+
+namespace {
+
+using int_range = decltype( estd::range( 10 ) );
+using power_range = decltype( estd::logspace( 0.0, 2.0, 3 ) );
+
+static_assert( std::ranges::view< int_range > && std::ranges::borrowed_range< int_range >,
+               "ranges are borrowed views" );
+static_assert( std::ranges::random_access_range< int_range >
+               && std::ranges::sized_range< int_range >
+               && std::ranges::common_range< int_range >,
+               "ranges are sized random access ranges" );
+static_assert( std::ranges::random_access_range< decltype( estd::range( 0.0, 1.0, 0.1 ) ) >
+               && std::ranges::sized_range< decltype( estd::range( 0.0, 1.0, 0.1 ) ) >,
+               "floating point ranges are sized random access ranges" );
+static_assert( std::ranges::view< decltype( estd::down_range( 5u, 0u ) ) >
+               && std::ranges::random_access_range< decltype( estd::down_range( 5u, 0u ) ) >,
+               "ranges with a compile time direction are random access views" );
+static_assert( std::ranges::random_access_range< power_range >
+               && std::ranges::view< power_range >
+               && std::ranges::borrowed_range< power_range >,
+               "logspace and geomspace are random access borrowed views" );
+
+// The values of a view, whatever its sentinel.
+template< typename View >
+auto collect( View view ) -> std::vector< std::ranges::range_value_t< View > > {
+   std::vector< std::ranges::range_value_t< View > > values;
+   for( auto val : view ) { values.push_back( val ); }
+   return values;
+}
+
+} // namespace
+
+SCENARIO( "Ranges as std::ranges views", "[range][ranges]" )
+{
+   GIVEN( "ranges combined with standard view adaptors" )
+   {
+      WHEN( "the adaptors are applied" )
+      {
+         auto squares = estd::range( 5 ) | std::views::transform( []( int i ) { return i * i; } );
+         auto first_two = estd::range( 10, 0, -3 ) | std::views::take( 2 );
+         auto reversed = estd::logspace( 0.0, 2.0, 3 ) | std::views::reverse;
+         auto backwards = estd::range( 0, 10, 4 ) | std::views::reverse;
+         auto sizes = estd::range( 10 ).chunks( 4 )
+                        | std::views::transform( []( auto chunk ) { return chunk.size(); } );
+         THEN( "the values are computed lazily, as iteration gives them." )
+         {
+            REQUIRE( std::ranges::size( squares ) == 5 );
+            REQUIRE( ( collect( squares ) == std::vector< int >{ 0, 1, 4, 9, 16 } ) );
+            REQUIRE( ( collect( first_two ) == std::vector< int >{ 10, 7 } ) );
+            REQUIRE( ( collect( reversed ) == std::vector< double >{ 100.0, 10.0, 1.0 } ) );
+            REQUIRE( ( collect( backwards ) == std::vector< int >{ 8, 4, 0 } ) );
+            REQUIRE( backwards[1] == 4 );
+            REQUIRE( ( collect( sizes ) == std::vector< std::size_t >{ 4, 4, 2 } ) );
+            REQUIRE( std::ranges::random_access_range< decltype( estd::range( 10 ).slide( 2 ) ) > );
+         }
+      }
+
+      WHEN( "an algorithm searches a temporary range" )
+      {
+         auto const found = std::ranges::find( estd::range( 2, 20, 3 ), 11 );
+         THEN( "the iterator returned is still usable." )
+         {
+            REQUIRE( *found == 11 );
+         }
+      }
+   }
+}
+
+#endif
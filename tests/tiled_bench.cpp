@@ -0,0 +1,119 @@
+//
+// Copyright 2018 Ghyslain Leclerc
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Compares plain and cache tiled traversals of an index space on a matrix
+// transpose and a 3D 7 point stencil.
+//
+// Usage: range_fn_tiled_bench [matrix_size] [grid_size]
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../tiled.hxx"
+
+
+namespace {
+
+template< typename Function >
+double seconds( Function&& fn ) {
+   auto const start = std::chrono::steady_clock::now();
+   fn();
+   return std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+}
+
+// Best of a few runs, to skip the first touch of the pages.
+template< typename Function >
+double best_of( Function&& fn ) {
+   auto best = seconds( fn );
+   for( auto run : estd::range( 4 ) ) {
+      (void)run;
+      auto const time = seconds( fn );
+      best = ( time < best ) ? time : best;
+   }
+   return best;
+}
+
+} // namespace
+
+
+int main( int argc, char* argv[] ) {
+   auto const size = ( argc > 1 ) ? std::atoi( argv[1] ) : 4096;
+   auto const grid = ( argc > 2 ) ? std::atoi( argv[2] ) : 256;
+   std::printf( "L1 %zu KiB, L2 %zu KiB, L3 %zu KiB\n",
+                estd::cache_size( 1 ) >> 10, estd::cache_size( 2 ) >> 10,
+                estd::cache_size( 3 ) >> 10 );
+
+   // Transpose: plain reads rows and writes columns, a whole cache line per
+   // element written once the matrix no longer fits.
+   {
+      std::vector< float > src( static_cast< std::size_t >( size ) * size, 1.0f );
+      std::vector< float > dst( src.size() );
+      auto const points = estd::range_nd( { size, size } );
+      auto const tile = estd::cache_tile< 2 >( 2 * sizeof( float ) );
+
+      auto const plain = best_of( [&] {
+         for( auto idx : points ) {
+            dst[ static_cast< std::size_t >( idx[1] ) * size + idx[0] ] =
+               src[ static_cast< std::size_t >( idx[0] ) * size + idx[1] ];
+         }
+      } );
+      auto const tiled = best_of( [&] {
+         for( auto const& block : estd::tiled( points, tile ) ) {
+            for( auto idx : block ) {
+               dst[ static_cast< std::size_t >( idx[1] ) * size + idx[0] ] =
+                  src[ static_cast< std::size_t >( idx[0] ) * size + idx[1] ];
+            }
+         }
+      } );
+      std::printf( "transpose %dx%d, tiles of %zux%zu: plain %.4f s, tiled %.4f s (%.2fx)\n",
+                   size, size, tile[0], tile[1], plain, tiled, plain / tiled );
+   }
+
+   // 7 point stencil: plain reuses the neighbouring planes from cache only
+   // while three of them fit.
+   {
+      auto const num = static_cast< std::size_t >( grid );
+      std::vector< float > in( num * num * num, 1.0f );
+      std::vector< float > out( in.size() );
+      auto const points = estd::range_nd( { 1, 1, 1 }, { grid - 1, grid - 1, grid - 1 },
+                                          { 1, 1, 1 } );
+      // Whole rows, so the inner loop stays contiguous: only the outer two
+      // axes are tiled, for slabs of both grids to fit in L2.
+      auto const outer = estd::cache_tile< 2 >( 2 * num * sizeof( float ), 2 );
+      std::array< std::size_t, 3 > const tile{ { outer[0], outer[1], num } };
+      auto stencil = [&]( std::array< int, 3 > idx ) {
+         auto const at = ( static_cast< std::size_t >( idx[0] ) * num + idx[1] ) * num + idx[2];
+         out[at] = 0.5f * in[at] + 0.0833f * ( in[at - 1] + in[at + 1]
+                                                 + in[at - num] + in[at + num]
+                                                 + in[at - num * num] + in[at + num * num] );
+      };
+
+      auto const plain = best_of( [&] {
+         for( auto idx : points ) { stencil( idx ); }
+      } );
+      auto const tiled = best_of( [&] {
+         for( auto const& block : estd::tiled( points, tile ) ) {
+            for( auto idx : block ) { stencil( idx ); }
+         }
+      } );
+      std::printf( "stencil %d^3, tiles of %zux%zux%zu: plain %.4f s, tiled %.4f s (%.2fx)\n",
+                   grid, tile[0], tile[1], tile[2], plain, tiled, plain / tiled );
+   }
+   return 0;
+}
@@ -0,0 +1,130 @@
+//
+// Copyright 2018 Ghyslain Leclerc
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+
+#include "./catch.hpp"
+
+#include "tiled.hxx"
+
+//==============================================================================
+SCENARIO( "Tiled iteration over an index space", "[tiled]" )
+{
+   GIVEN( "a two dimensional range whose extents are not multiples of the tile" )
+   {
+      auto rng = estd::range_nd( { 10, 7 } );
+      auto tiles = estd::tiled( rng, { 4, 3 } );
+
+      WHEN( "the tiles and their points are iterated" )
+      {
+         std::vector<int> visits( 70, 0 );
+         std::vector< std::array<std::size_t, 2> > extents;
+         std::vector< std::array<int, 2> > firsts;
+         for( auto tile : tiles ) {
+            extents.push_back( tile.extents() );
+            firsts.push_back( tile.front() );
+            for( auto idx : tile ) { ++visits[ idx[0] * 7 + idx[1] ]; }
+         }
+         THEN( "every point is visited once, in tiles clipped at the edges." )
+         {
+            REQUIRE( tiles.size() == 9 );
+            REQUIRE( visits == std::vector<int>( 70, 1 ) );
+            REQUIRE( ( firsts[1] == std::array<int, 2>{ { 0, 3 } } ) );
+            REQUIRE( ( firsts[3] == std::array<int, 2>{ { 4, 0 } } ) );
+            REQUIRE( ( extents[0] == std::array<std::size_t, 2>{ { 4, 3 } } ) );
+            REQUIRE( ( extents[2] == std::array<std::size_t, 2>{ { 4, 1 } } ) );
+            REQUIRE( ( extents[8] == std::array<std::size_t, 2>{ { 2, 1 } } ) );
+         }
+      }
+
+      WHEN( "the tiles are accessed at random or sliced" )
+      {
+         auto tile = tiles[4];
+         auto rest = tiles.slice( 5, 9 );
+         THEN( "the tiles are those of the same positions." )
+         {
+            REQUIRE( ( tile.front() == std::array<int, 2>{ { 4, 3 } } ) );
+            REQUIRE( ( tile.back() == std::array<int, 2>{ { 7, 5 } } ) );
+            REQUIRE( rest.size() == 4 );
+            REQUIRE( ( ( *rest.begin() ).front() == tiles[5].front() ) );
+            REQUIRE( rest.end() - rest.begin() == 4 );
+         }
+      }
+
+      WHEN( "a slice of the range is tiled" )
+      {
+         THEN( "it is rejected, its points do not form a box." )
+         {
+            REQUIRE_THROWS_AS( estd::tiled( rng.slice( 3, 40 ), { 4, 3 } ), std::invalid_argument );
+            REQUIRE( estd::tiled( rng.slice( 0, 70 ), { 4, 3 } ).size() == 9 );
+         }
+      }
+   }
+
+   GIVEN( "a three dimensional range with steps" )
+   {
+      auto rng = estd::range_nd( { 0, 100, 0 }, { 9, 0, 5 }, { 2, -10, 1 } );
+      auto tiles = estd::tiled( rng, { 2, 4, 8 } );
+
+      WHEN( "the points of all the tiles are collected" )
+      {
+         std::size_t num_points{0};
+         bool inside = true;
+         for( auto tile : tiles ) {
+            for( auto idx : tile ) {
+               ++num_points;
+               inside = inside && idx[0] % 2 == 0 && idx[0] <= 8
+                               && idx[1] % 10 == 0 && idx[1] > 0 && idx[2] < 5;
+            }
+         }
+         THEN( "they are the points of the range." )
+         {
+            REQUIRE( num_points == rng.size() );
+            REQUIRE( inside );
+            REQUIRE( tiles.size() == 3 * 3 * 1 );
+         }
+      }
+   }
+}
+
+
+
+//==============================================================================
+SCENARIO( "Tile sizes from the cache sizes", "[tiled][cache]" )
+{
+   GIVEN( "the caches of the machine" )
+   {
+      THEN( "their sizes grow with the level." )
+      {
+         REQUIRE( estd::cache_size( 1 ) >= 4096 );
+         REQUIRE( estd::cache_size( 2 ) >= estd::cache_size( 1 ) );
+         REQUIRE( estd::cache_size( 3 ) >= estd::cache_size( 2 ) );
+      }
+
+      THEN( "tiles fit in half the cache, in multiples of 8 points." )
+      {
+         auto const tile = estd::cache_tile< 2 >( 2 * sizeof( float ) );
+         REQUIRE( tile[0] == tile[1] );
+         REQUIRE( tile[0] % 8 == 0 );
+         REQUIRE( tile[0] * tile[1] * 2 * sizeof( float ) <= estd::cache_size( 1 ) / 2 );
+         REQUIRE( estd::cache_tile< 3 >( 1 << 30 )[2] == 8 );
+      }
+   }
+}
@@ -0,0 +1,99 @@
+//
+// Copyright 2018 Ghyslain Leclerc
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Compares a range based for loop with Range::unrolled< 2, 4, 8 > on loop
+// bodies of increasing size: a polynomial of degree 1, 4 and 16 evaluated at
+// every other element of an array (a step the vectorizer does not handle).
+//
+// Usage: range_fn_unrolled_bench [elements] [step]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../range.hxx"
+
+
+namespace {
+
+template< typename Function >
+double seconds( Function&& fn ) {
+   auto const start = std::chrono::steady_clock::now();
+   fn();
+   return std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+}
+
+// Best of a few runs, to skip the first touch of the pages.
+template< typename Function >
+double best_of( Function&& fn ) {
+   auto best = seconds( fn );
+   for( auto run : estd::range( 4 ) ) {
+      (void)run;
+      auto const time = seconds( fn );
+      best = ( time < best ) ? time : best;
+   }
+   return best;
+}
+
+// out[idx] = p( in[idx] ), p of degree `Degree`, by Horner's rule.
+template< int Degree >
+struct polynomial
+{
+   float const* in;
+   float* out;
+
+   void operator()( int idx ) const {
+      auto const x = in[idx];
+      auto value = 1.0f;
+      for( auto term : estd::up_range( Degree ) ) {
+         (void)term;
+         value = value * x + 0.5f;
+      }
+      out[idx] = value;
+   }
+};
+
+template< int Degree >
+void compare( int size, int step ) {
+   std::vector< float > in( static_cast< std::size_t >( size ), 0.999f );
+   std::vector< float > out( in.size() );
+   polynomial< Degree > const body{ in.data(), out.data() };
+   auto rng = estd::range( 0, size, step );
+   auto const per_element = 1e9 / static_cast< double >( rng.size() );
+
+   auto const plain = best_of( [&] {
+      for( auto idx : rng ) { body( idx ); }
+   } ) * per_element;
+   auto const by_2 = best_of( [&] { rng.unrolled< 2 >( body ); } ) * per_element;
+   auto const by_4 = best_of( [&] { rng.unrolled< 4 >( body ); } ) * per_element;
+   auto const by_8 = best_of( [&] { rng.unrolled< 8 >( body ); } ) * per_element;
+   std::printf( "degree %2d: plain %.3f ns, unrolled by 2 %.3f ns, by 4 %.3f ns, "
+                "by 8 %.3f ns per element\n", Degree, plain, by_2, by_4, by_8 );
+}
+
+} // namespace
+
+
+int main( int argc, char* argv[] ) {
+   auto const size = ( argc > 1 ) ? std::atoi( argv[1] ) : 1 << 16;
+   auto const step = ( argc > 2 ) ? std::atoi( argv[2] ) : 2;
+   std::printf( "%d elements, step %d\n", size, step );
+   compare< 1 >( size, step );
+   compare< 4 >( size, step );
+   compare< 16 >( size, step );
+   return 0;
+}
@@ -0,0 +1,364 @@
+//
+// Copyright 2018 Ghyslain Leclerc
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef RANGE_FN_TILED_HXX_
+#define RANGE_FN_TILED_HXX_
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined( __linux__ )
+#  include <unistd.h>
+#endif
+
+#include "range.hxx"
+
+
+namespace estd {
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//! @brief Iterator on the tiles of a tiled_range.  Moves through the grid of
+//! tiles and builds the tile it is on when dereferenced.
+template< typename T, std::size_t N, layout order >
+struct tile_iterator
+{
+   using grid_iterator = nd_iterator< std::size_t, N, order >;
+
+public:
+   using value_type = nd_range< T, N, order >;
+   using reference = nd_range< T, N, order >;
+   using iterator_category = std::random_access_iterator_tag;
+   using pointer = nd_range< T, N, order > const*;
+   using difference_type = std::ptrdiff_t;
+
+   insist_inline
+   tile_iterator() : grid_{}, axes_{}, extents_{} {
+   }
+
+   insist_inline
+   tile_iterator( grid_iterator grid, nd_axes< T, N > const& axes,
+                  std::array< std::size_t, N > const& extents ) :
+      grid_( grid ), axes_( axes ), extents_( extents ) {
+   }
+
+   //! The points of the tile, clipped to the tiled range.
+   insist_inline
+   auto operator*() const -> nd_range< T, N, order > {
+      auto const tile = *grid_;
+      nd_axes< T, N > axes;
+      for( std::size_t axis{0}; axis != N; ++axis ) {
+         auto const first = tile[axis] * extents_[axis];
+         auto const left = axes_.counts[axis] - first;
+         axes.firsts[axis] = nth_value( axes_.firsts[axis], axes_.steps[axis],
+                                        static_cast< std::ptrdiff_t >( first ) );
+         axes.steps[axis] = axes_.steps[axis];
+         axes.counts[axis] = ( left < extents_[axis] ) ? left : extents_[axis];
+      }
+      return nd_range< T, N, order >{ axes };
+   }
+
+   insist_inline
+   auto operator[]( std::ptrdiff_t n ) const -> nd_range< T, N, order > {
+      return *( *this + n );
+   }
+
+   insist_inline
+   auto operator++() -> tile_iterator& {
+      ++grid_;
+      return *this;
+   }
+
+   insist_inline
+   auto operator++( int ) -> tile_iterator {
+      auto copy = *this;
+      ++grid_;
+      return copy;
+   }
+
+   insist_inline
+   auto operator--() -> tile_iterator& {
+      --grid_;
+      return *this;
+   }
+
+   insist_inline
+   auto operator--( int ) -> tile_iterator {
+      auto copy = *this;
+      --grid_;
+      return copy;
+   }
+
+   insist_inline
+   auto operator+=( std::ptrdiff_t n ) -> tile_iterator& {
+      grid_ += n;
+      return *this;
+   }
+
+   insist_inline
+   auto operator-=( std::ptrdiff_t n ) -> tile_iterator& {
+      grid_ -= n;
+      return *this;
+   }
+
+   insist_inline
+   friend auto operator+( tile_iterator iter, std::ptrdiff_t n ) -> tile_iterator {
+      return iter += n;
+   }
+
+   insist_inline
+   friend auto operator+( std::ptrdiff_t n, tile_iterator iter ) -> tile_iterator {
+      return iter += n;
+   }
+
+   insist_inline
+   friend auto operator-( tile_iterator iter, std::ptrdiff_t n ) -> tile_iterator {
+      return iter -= n;
+   }
+
+   insist_inline
+   auto operator-( tile_iterator const& rhs ) const -> std::ptrdiff_t {
+      return grid_ - rhs.grid_;
+   }
+
+   insist_inline
+   auto operator==( tile_iterator const& rhs ) const -> bool {
+      return grid_ == rhs.grid_;
+   }
+
+   insist_inline
+   auto operator!=( tile_iterator const& rhs ) const -> bool {
+      return grid_ != rhs.grid_;
+   }
+
+   insist_inline
+   auto operator<( tile_iterator const& rhs ) const -> bool {
+      return grid_ < rhs.grid_;
+   }
+
+   insist_inline
+   auto operator>( tile_iterator const& rhs ) const -> bool {
+      return grid_ > rhs.grid_;
+   }
+
+   insist_inline
+   auto operator<=( tile_iterator const& rhs ) const -> bool {
+      return grid_ <= rhs.grid_;
+   }
+
+   insist_inline
+   auto operator>=( tile_iterator const& rhs ) const -> bool {
+      return grid_ >= rhs.grid_;
+   }
+
+private:
+   grid_iterator grid_;
+   nd_axes< T, N > axes_;
+   std::array< std::size_t, N > extents_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief The points of an nd_range grouped in tiles of at most `extents`
+//! points along each axis.  Returned by tiled.
+//!
+//! Tiles are visited in the order of the range, and so are the points within
+//! a tile.  Like nd_range, the tiles can be sliced and split, e.g. by
+//! parallel_for.
+template< typename T, std::size_t N, layout order >
+struct tiled_range
+{
+   using grid_range = nd_range< std::size_t, N, order >;
+
+public:
+   using iterator = tile_iterator< T, N, order >;
+
+   insist_inline
+   tiled_range( grid_range const& grid, nd_axes< T, N > const& axes,
+                std::array< std::size_t, N > const& extents ) :
+      grid_( grid ), axes_( axes ), extents_( extents ) {
+   }
+
+   insist_inline
+   auto begin() const -> iterator {
+      return iterator{ grid_.begin(), axes_, extents_ };
+   }
+
+   insist_inline
+   auto end() const -> iterator {
+      return iterator{ grid_.end(), axes_, extents_ };
+   }
+
+   //! Number of tiles.
+   insist_inline
+   auto size() const -> std::size_t {
+      return grid_.size();
+   }
+
+   insist_inline
+   auto empty() const -> bool {
+      return grid_.empty();
+   }
+
+   //! Tile at position `idx`, without bounds checking.
+   insist_inline
+   auto operator[]( std::size_t idx ) const -> nd_range< T, N, order > {
+      return begin()[ static_cast< std::ptrdiff_t >( idx ) ];
+   }
+
+   //! Tiles at positions [first, last[, as a range of the same type.
+   insist_inline
+   auto slice( std::size_t first, std::size_t last ) const -> tiled_range {
+      return tiled_range{ grid_.slice( first, last ), axes_, extents_ };
+   }
+
+   insist_inline
+   auto split() const -> std::pair< tiled_range, tiled_range > {
+      auto const halves = grid_.split();
+      return std::make_pair( tiled_range{ halves.first, axes_, extents_ },
+                             tiled_range{ halves.second, axes_, extents_ } );
+   }
+
+private:
+   grid_range grid_;
+   nd_axes< T, N > axes_;
+   std::array< std::size_t, N > extents_;
+};
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Parses a sysfs cache size, such as "48K".
+inline auto parse_cache_size( std::string const& text ) -> std::size_t {
+   std::size_t idx{0};
+   std::size_t value{0};
+   for( ; idx != text.size() && text[idx] >= '0' && text[idx] <= '9'; ++idx ) {
+      value = value * 10 + static_cast< std::size_t >( text[idx] - '0' );
+   }
+   if( idx != text.size() ) {
+      if( text[idx] == 'K' ) { value <<= 10; }
+      if( text[idx] == 'M' ) { value <<= 20; }
+      if( text[idx] == 'G' ) { value <<= 30; }
+   }
+   return value;
+}
+
+//! Size of the data (or unified) cache of `level`, read from sysfs, or 0.
+inline auto sysfs_cache_size( unsigned level ) -> std::size_t {
+   for( auto index : estd::range( 16 ) ) {
+      auto const dir = "/sys/devices/system/cpu/cpu0/cache/index"
+                          + std::to_string( index ) + "/";
+      std::ifstream level_file{ dir + "level" };
+      unsigned cache_level{0};
+      if( !( level_file >> cache_level ) ) { break; }
+      std::string type;
+      std::ifstream{ dir + "type" } >> type;
+      if( cache_level != level || type == "Instruction" ) { continue; }
+      std::string size;
+      std::ifstream{ dir + "size" } >> size;
+      return parse_cache_size( size );
+   }
+   return 0;
+}
+
+} // namespace detail
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Size in bytes of the data cache of `level` (1 to 3) of the CPU.
+//!
+//! On Linux, asks sysconf, then sysfs.  When neither knows, or elsewhere,
+//! returns typical sizes: 32 KiB, 256 KiB and 8 MiB.
+inline auto cache_size( unsigned level = 1 ) -> std::size_t {
+#if defined( __linux__ )
+   long bytes{ -1 };
+#  if defined( _SC_LEVEL1_DCACHE_SIZE )
+   if( level == 1 ) { bytes = sysconf( _SC_LEVEL1_DCACHE_SIZE ); }
+   if( level == 2 ) { bytes = sysconf( _SC_LEVEL2_CACHE_SIZE ); }
+   if( level == 3 ) { bytes = sysconf( _SC_LEVEL3_CACHE_SIZE ); }
+#  endif
+   if( bytes > 0 ) { return static_cast< std::size_t >( bytes ); }
+   auto const sysfs_bytes = detail::sysfs_cache_size( level );
+   if( sysfs_bytes > 0 ) { return sysfs_bytes; }
+#endif
+   return ( level <= 1 ) ? std::size_t{ 32 } << 10 :
+          ( level == 2 ) ? std::size_t{ 256 } << 10 : std::size_t{ 8 } << 20;
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief Extents of a cubic tile of `N` dimensions whose data fits in half
+//! the cache of `level`, `bytes_per_point` being the bytes the loop body
+//! touches per point (e.g. 2 * sizeof( float ) to transpose floats).
+//!
+//! The side is rounded down to a multiple of 8 points, and is at least 8.
+template< std::size_t N >
+inline auto cache_tile( std::size_t bytes_per_point, unsigned level = 1 )
+                                             -> std::array< std::size_t, N > {
+   auto const points = static_cast< double >( cache_size( level ) / 2 )
+                        / static_cast< double >( bytes_per_point );
+   auto side = static_cast< std::size_t >(
+      std::pow( points, 1.0 / static_cast< double >( N ) )
+   ) / 8 * 8;
+   if( side < 8 ) { side = 8; }
+   std::array< std::size_t, N > extents;
+   extents.fill( side );
+   return extents;
+}
+
+
+
+//------------------------------------------------------------------------------
+//! @brief The points of `rng` in tiles of at most `extents` points along each
+//! axis, e.g. `tiled( range_nd( { rows, cols } ), { 64, 64 } )`.
+//!
+//! Each tile is itself an nd_range, iterated in the order of `rng`.  `rng`
+//! must be a whole range_nd, not a slice of one: the points of a slice do not
+//! form a box, and the tiles are cut from the axes.  A slice throws
+//! std::invalid_argument.
+template< typename T, std::size_t N, layout order >
+insist_inline auto tiled( detail::nd_range< T, N, order > const& rng,
+                          std::array< std::size_t, N > const& extents )
+                                             -> detail::tiled_range< T, N, order > {
+   auto const& axes = rng.axes();
+   if( rng.size() != axes.size() ) {
+      throw std::invalid_argument( "tiled() needs a whole range_nd, not a slice." );
+   }
+   auto clamped = extents;
+   detail::nd_axes< std::size_t, N > grid;
+   for( std::size_t axis{0}; axis != N; ++axis ) {
+      clamped[axis] = ( extents[axis] > 0 ) ? extents[axis] : 1;
+      grid.firsts[axis] = 0;
+      grid.steps[axis] = 1;
+      grid.counts[axis] = ( axes.counts[axis] + clamped[axis] - 1 ) / clamped[axis];
+   }
+   return detail::tiled_range< T, N, order >{
+      detail::nd_range< std::size_t, N, order >{ grid }, axes, clamped
+   };
+}
+
+} // namespace estd
+
+#endif // RANGE_FN_TILED_HXX_